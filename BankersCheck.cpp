@@ -0,0 +1,106 @@
+#include <iostream>
+#include <string>
+#include <random>
+#include <stdexcept>
+
+#include "SystemState.h"
+#include "Trace.h"
+
+using namespace std;
+
+/**
+ * Draws a device vector with, in each configured class, a count from 0 to the
+ * count in limit.
+ */
+DeviceVector random_devices(mt19937& random, const DeviceVector& limit, int device_classes) {
+    DeviceVector devices;
+    for (int c = 0; c < device_classes; c++) {
+        devices[c] = random() % (limit[c] + 1);
+    }
+    return devices;
+}
+
+/**
+ * Runs one random case: a system with one device class (even seeds, which
+ * DeviceNeedIndex checks in one pass over the jobs sorted by need) or two to
+ * four (odd seeds, checked in passes in any order), and up to 12 jobs. The job
+ * on the CPU requests or releases random devices within its claim, and runs a
+ * time unit per turn until every job has completed or none is left to run.
+ *
+ * Every request of the job on the CPU is checked with both bankers_valid() and
+ * bankers_valid_textbook(). Requests of waiting jobs, which update_queues()
+ * re-evaluates, are compared by Options::check_bankers.
+ *
+ * @return The number of requests compared.
+ */
+unsigned long run_case(unsigned int seed, bool inclusive) {
+    mt19937 random(seed);
+    int device_classes = (seed % 2 == 0) ? 1 : 2 + random() % 3;
+    DeviceVector max_devices;
+    for (int c = 0; c < device_classes; c++) {
+        max_devices[c] = 1 + random() % 8;
+    }
+    Options options;
+    options.bankers_inclusive = inclusive;
+    options.check_bankers = true;
+    SystemState state(1 << 30, 1 << 30, max_devices, device_classes, 1, 0, options);
+    
+    int jobs = 1 + random() % 12;
+    for (int number = 1; number <= jobs; number++) {
+        int job_id = state.add_job(Job(0, number, 1,
+                                       random_devices(random, max_devices, device_classes),
+                                       1 + random() % 20, 1));
+        state.schedule_job(SystemState::JobQueue::Ready, job_id);
+    }
+    state.update_queues();
+    
+    unsigned long compared = 0;
+    for (int time = 1; state.cpu_get_job() != NoJob; time++) {
+        int job_id = state.cpu_get_job();
+        const JobTable& table = state.get_jobs();
+        if (random() % 3 != 0) {
+            DeviceVector need = table.get_max_devices(job_id) - table.get_allocated_devices(job_id);
+            state.cpu_request_devices(random_devices(random, need, device_classes));
+            if (state.bankers_valid(job_id) != state.bankers_valid_textbook(job_id)) {
+                throw runtime_error("Error: Banker's algorithm results disagree.");
+            }
+            compared++;
+        } else {
+            state.cpu_release_devices(random_devices(random, table.get_allocated_devices(job_id),
+                                                     device_classes));
+        }
+        state.set_time(time);
+        state.end_quantum();
+        state.update_queues();
+    }
+    return compared;
+}
+
+/**
+ * Checks the banker's safety check of DeviceNeedIndex against the textbook
+ * algorithm on random device requests and releases, with the strict (Need <
+ * Work) and the inclusive (Need <= Work) rule. Usage: bankers_check [cases]
+ *
+ * @param argc The number of command line arguments.
+ * @param argv An array of command line arguments.
+ * @return Returns 0 if the algorithms agree on every request, 1 otherwise.
+ */
+int main(int argc, char** argv) {
+    int cases = (argc > 1) ? stoi(argv[1]) : 2000;
+    Trace::set_level(TraceLevel::None);
+    
+    for (bool inclusive : { false, true }) {
+        const char* mode = inclusive ? "inclusive" : "strict";
+        unsigned long compared = 0;
+        for (int seed = 1; seed <= cases; seed++) {
+            try {
+                compared += run_case(seed, inclusive);
+            } catch (const exception& e) {
+                cerr << e.what() << " (" << mode << ", seed " << seed << ")" << endl;
+                return 1;
+            }
+        }
+        cout << mode << ": " << cases << " cases, " << compared << " requests agree" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,346 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <new>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "SystemState.h"
+#include "DeviceReleaseEvent.h"
+#include "CommandParser.h"
+#include "Trace.h"
+
+using namespace std;
+
+// Allocations counted by the replaced global operator new below
+static unsigned long s_allocations = 0;
+
+void* operator new(size_t size) {
+    s_allocations++;
+    void* p = malloc((size == 0) ? 1 : size);
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+/**
+ * The time and allocations of the measured sections of a benchmark. Setup done
+ * outside of start() and stop() is not counted. Operations are run in batches
+ * between two clock reads, which grow until a batch takes a millisecond.
+ */
+class Measurement {
+public:
+    Measurement() 
+    : m_operations(0), m_time(0), m_allocations(0), m_start_allocations(0), m_batch(1) {
+    }
+    
+    void start() {
+        m_start_allocations = s_allocations;
+        m_start_time = chrono::steady_clock::now();
+    }
+    
+    void stop(unsigned long operations) {
+        chrono::steady_clock::duration elapsed = chrono::steady_clock::now() - m_start_time;
+        m_time += elapsed;
+        m_allocations += s_allocations - m_start_allocations;
+        m_operations += operations;
+        if (elapsed < chrono::milliseconds(1)) {
+            m_batch *= 2;
+        }
+    }
+    
+    /** @brief Gets the number of operations to run in the next batch. */
+    unsigned long get_batch() const { return m_batch; }
+    
+    /** @brief Checks if enough time was measured for stable numbers. */
+    bool done() const { return m_time >= MIN_TIME; }
+    
+    unsigned long get_operations() const { return m_operations; }
+    double get_ns_per_op() const {
+        return chrono::duration<double, nano>(m_time).count() / m_operations;
+    }
+    double get_allocations_per_op() const { return m_allocations / (double) m_operations; }
+
+private:
+    static constexpr chrono::milliseconds MIN_TIME{200};
+    
+    unsigned long m_operations;
+    chrono::steady_clock::duration m_time;
+    unsigned long m_allocations;
+    chrono::steady_clock::time_point m_start_time;
+    unsigned long m_start_allocations;
+    unsigned long m_batch;
+};
+
+/**
+ * Makes a system with one device class and plenty of memory, in which jobs
+ * never count as long jobs.
+ */
+unique_ptr<SystemState> make_state(int devices) {
+    return make_unique<SystemState>(1 << 30, 1 << 30, DeviceVector(devices), 1, 4, 0);
+}
+
+/**
+ * Adds jobs that need a given number of devices to the ready queue, and puts the
+ * first of them on the CPU.
+ */
+void add_ready_jobs(SystemState& state, int count, int max_devices) {
+    for (int number = 1; number <= count; number++) {
+        int job_id = state.add_job(Job(0, number, 1, DeviceVector(max_devices), 1000, 1));
+        state.schedule_job(SystemState::JobQueue::Ready, job_id);
+    }
+    state.update_queues();
+}
+
+/**
+ * Lets the job on the CPU request devices and takes it off the CPU, which grants
+ * the request or moves the job to the wait queue, and puts the next job on.
+ */
+void request_and_rotate(SystemState& state, int devices) {
+    state.cpu_request_devices(DeviceVector(devices));
+    state.end_quantum();
+    state.update_queues();
+}
+
+/**
+ * Schedules an event and takes the earliest event off the queue, with a given
+ * number of events pending.
+ */
+void bench_schedule_event(int pending, Measurement& measurement) {
+    unique_ptr<SystemState> state = make_state(1);
+    mt19937 random(1);
+    for (int i = 0; i < pending; i++) {
+        state->schedule_event(state->new_event<DeviceReleaseEvent>(random() % 1000000, 1,
+                                                                   DeviceVector()));
+    }
+    while (!measurement.done()) {
+        unsigned long batch = measurement.get_batch();
+        measurement.start();
+        for (unsigned long i = 0; i < batch; i++) {
+            state->schedule_event(state->new_event<DeviceReleaseEvent>(random() % 1000000, 1,
+                                                                       DeviceVector()));
+            state->release_event(state->pop_next_event());
+        }
+        measurement.stop(batch);
+    }
+}
+
+/**
+ * Ends the quantum of the job on the CPU, which update_queues() moves to the
+ * back of the ready queue, with a given number of active jobs.
+ */
+void bench_update_queues(int active_jobs, Measurement& measurement) {
+    unique_ptr<SystemState> state = make_state(1);
+    add_ready_jobs(*state, active_jobs, 0);
+    while (!measurement.done()) {
+        unsigned long batch = measurement.get_batch();
+        measurement.start();
+        for (unsigned long i = 0; i < batch; i++) {
+            state->end_quantum();
+            state->update_queues();
+        }
+        measurement.stop(batch);
+    }
+}
+
+/**
+ * Like bench_update_queues(), with a given number of jobs in the wait queue that
+ * are re-evaluated on every pass. One job holds one of the three devices, and
+ * every waiting job has requested the other two, which would be unsafe.
+ */
+void bench_update_queues_wait(int waiting_jobs, Measurement& measurement) {
+    unique_ptr<SystemState> state = make_state(3);
+    add_ready_jobs(*state, waiting_jobs + 1, 2);
+    for (int i = 0; i <= waiting_jobs; i++) {
+        request_and_rotate(*state, (i == 0) ? 1 : 2);
+    }
+    while (!measurement.done()) {
+        unsigned long batch = measurement.get_batch();
+        measurement.start();
+        for (unsigned long i = 0; i < batch; i++) {
+            // Releasing nothing still makes the wait queue due for evaluation
+            state->cpu_release_devices(DeviceVector());
+            state->end_quantum();
+            state->update_queues();
+        }
+        measurement.stop(batch);
+    }
+}
+
+/**
+ * Checks a safe device request of the job on the CPU, with a given number of
+ * active jobs that each hold one of the two devices they may claim.
+ */
+template <bool Textbook>
+void bench_bankers(int active_jobs, Measurement& measurement) {
+    unique_ptr<SystemState> state = make_state(2 * active_jobs);
+    add_ready_jobs(*state, active_jobs, 2);
+    for (int i = 0; i < active_jobs; i++) {
+        request_and_rotate(*state, 1);
+    }
+    state->cpu_request_devices(DeviceVector(1));
+    int requester = state->cpu_get_job();
+    unsigned long safe = 0;
+    while (!measurement.done()) {
+        unsigned long batch = measurement.get_batch();
+        measurement.start();
+        for (unsigned long i = 0; i < batch; i++) {
+            safe += Textbook ? state->bankers_valid_textbook(requester)
+                             : state->bankers_valid(requester);
+        }
+        measurement.stop(batch);
+    }
+    if (safe != measurement.get_operations()) {
+        throw runtime_error("Error: Benchmark request was not safe.");
+    }
+}
+
+/**
+ * Fills hold queue 1 with a given number of jobs of random runtimes, one
+ * schedule_job() per job.
+ */
+void bench_schedule_hold1(int held_jobs, Measurement& measurement) {
+    mt19937 random(1);
+    while (!measurement.done()) {
+        unique_ptr<SystemState> state = make_state(1);
+        vector<int> job_ids;
+        for (int number = 1; number <= held_jobs; number++) {
+            job_ids.push_back(state->add_job(Job(0, number, 1, DeviceVector(),
+                                                 1 + random() % 1000, 1)));
+        }
+        measurement.start();
+        for (int job_id : job_ids) {
+            state->schedule_job(SystemState::JobQueue::Hold1, job_id);
+        }
+        measurement.stop(held_jobs);
+    }
+}
+
+/**
+ * Measures one stage of a display (capturing the snapshot, or rendering its text
+ * or JSON) with a given number of jobs in the system.
+ */
+template <int Stage>
+void bench_display(int jobs, Measurement& measurement) {
+    unique_ptr<SystemState> state = make_state(1);
+    add_ready_jobs(*state, jobs, 0);
+    DisplaySnapshot snapshot;
+    OutputBuffer buffer;
+    state->capture_display(snapshot, true);
+    while (!measurement.done()) {
+        unsigned long batch = measurement.get_batch();
+        measurement.start();
+        for (unsigned long i = 0; i < batch; i++) {
+            if (Stage == 0) {
+                state->capture_display(snapshot, true);
+            } else if (Stage == 1) {
+                snapshot.write_text(buffer);
+            } else {
+                snapshot.write_json(buffer);
+            }
+            buffer.clear();
+        }
+        measurement.stop(batch);
+    }
+}
+
+/**
+ * Makes an input file of a given number of lines: a configuration, then job
+ * arrivals, device requests and releases, and displays.
+ */
+string make_input(int lines) {
+    mt19937 random(1);
+    string input = "C 1 M=200 L=6 S=12 Q=4\n";
+    for (int time = 2; time <= lines; time++) {
+        string number = to_string(1 + random() % 1000);
+        switch (random() % 8) {
+            case 0: input += "Q " + to_string(time) + " J=" + number + " D=3\n"; break;
+            case 1: input += "L " + to_string(time) + " J=" + number + " D=2\n"; break;
+            case 2: input += "D " + to_string(time) + "\n"; break;
+            default:
+                input += "A " + to_string(time) + " J=" + number + " M="
+                         + to_string(random() % 200) + " S=" + to_string(random() % 12)
+                         + " R=" + to_string(1 + random() % 50) + " P=1\n";
+                break;
+        }
+    }
+    return input;
+}
+
+/**
+ * Parses an input file of a given number of lines; an operation is one line.
+ */
+void bench_parse(int lines, Measurement& measurement) {
+    string input = make_input(lines);
+    while (!measurement.done()) {
+        measurement.start();
+        CommandParser parser(input);
+        for (Command command; parser.next(command);) {
+        }
+        measurement.stop(lines);
+    }
+}
+
+struct Benchmark {
+    string_view name;
+    string_view parameter;
+    void (*run)(int size, Measurement& measurement);
+    vector<int> sizes;
+};
+
+/**
+ * Measures the simulator's hot paths in isolation and prints, for each benchmark
+ * and size, the nanoseconds and heap allocations per operation as CSV. Usage:
+ * component_bench [name]
+ *
+ * Only benchmarks whose name contains the given name are run. Each is run until
+ * at least 200 ms have been measured; setup is not measured.
+ *
+ * @param argc The number of command line arguments.
+ * @param argv An array of command line arguments.
+ * @return Returns 0 upon success.
+ */
+int main(int argc, char** argv) {
+    const Benchmark BENCHMARKS[] = {
+        { "schedule_event", "pending_events", bench_schedule_event, { 100, 10000, 1000000 } },
+        { "update_queues", "active_jobs", bench_update_queues, { 10, 1000, 100000 } },
+        { "update_queues_wait", "waiting_jobs", bench_update_queues_wait, { 10, 100, 1000 } },
+        { "bankers_valid", "active_jobs", bench_bankers<false>, { 10, 100, 1000 } },
+        { "bankers_valid_textbook", "active_jobs", bench_bankers<true>, { 10, 100, 1000 } },
+        { "schedule_job_hold1", "held_jobs", bench_schedule_hold1, { 100, 10000 } },
+        { "capture_display", "jobs", bench_display<0>, { 10, 1000, 10000 } },
+        { "display_text", "jobs", bench_display<1>, { 10, 1000, 10000 } },
+        { "display_json", "jobs", bench_display<2>, { 10, 1000, 10000 } },
+        { "parse_command", "lines", bench_parse, { 1000, 100000 } },
+    };
+    string_view filter = (argc > 1) ? argv[1] : "";
+    Trace::set_level(TraceLevel::None);
+    
+    cout << "benchmark,parameter,size,operations,ns_per_op,allocations_per_op" << endl;
+    for (const Benchmark& benchmark : BENCHMARKS) {
+        if (benchmark.name.find(filter) == string_view::npos) {
+            continue;
+        }
+        for (int size : benchmark.sizes) {
+            Measurement measurement;
+            benchmark.run(size, measurement);
+            cout << benchmark.name << "," << benchmark.parameter << "," << size << ","
+                 << measurement.get_operations() << "," << measurement.get_ns_per_op() << ","
+                 << measurement.get_allocations_per_op() << endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <stdexcept>
+#include <cstring>
+
+#include "BinaryTrace.h"
+
+using namespace std;
+
+const char MAGIC[8] = {'C', 'S', '6', '4', '1', 'T', 'R', 'C'};
+// Versions 1 and 2 were development layouts, and are rejected
+const uint32_t VERSION = 3;
+const size_t VERSION_END = sizeof(MAGIC) + 4;
+
+// Record type codes
+enum RecordType : uint8_t {
+    CONFIGURATION = 0,
+    JOB_ARRIVAL = 1,
+    DEVICE_REQUEST = 2,
+    DEVICE_RELEASE = 3,
+    DISPLAY = 4,
+};
+
+void append_int32(string& buffer, int value) {
+    uint32_t bits = static_cast<uint32_t>(value);
+    for (int i = 0; i < 4; i++) {
+        buffer.push_back(static_cast<char>(bits >> (8 * i)));
+    }
+}
+
+void append_varint(string& buffer, int value) {
+    // Zigzag: 0, -1, 1, -2, ... become 0, 1, 2, 3, ...
+    uint32_t bits = (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    while (bits >= 0x80) {
+        buffer.push_back(static_cast<char>(bits | 0x80));
+        bits >>= 7;
+    }
+    buffer.push_back(static_cast<char>(bits));
+}
+
+void append_devices(string& buffer, const Command& command) {
+    append_varint(buffer, command.device_classes);
+    for (int i = 0; i < command.device_classes; i++) {
+        append_varint(buffer, command.devices[i]);
+    }
+}
+
+BinaryTraceWriter::BinaryTraceWriter(ostream& out) 
+: m_out(out), m_header_written(false), m_previous_time(0), m_buffer() {
+}
+
+void BinaryTraceWriter::write(const Command& command) {
+    m_buffer.clear();
+    if (!m_header_written) {
+        if (command.type != Command::Type::Configuration) {
+            throw runtime_error("Error: A trace must start with a system configuration.");
+        }
+        m_buffer.append(MAGIC, sizeof(MAGIC));
+        append_int32(m_buffer, VERSION);
+        append_varint(m_buffer, command.time);
+        append_varint(m_buffer, command.memory);
+        append_varint(m_buffer, command.time_excess);
+        append_devices(m_buffer, command);
+        append_varint(m_buffer, command.quantum_length);
+        m_header_written = true;
+        m_previous_time = command.time;
+        m_out.write(m_buffer.data(), m_buffer.size());
+        return;
+    }
+    switch (command.type) {
+        case Command::Type::Configuration:
+            m_buffer.push_back(CONFIGURATION);
+            append_varint(m_buffer, command.time - m_previous_time);
+            append_varint(m_buffer, command.memory);
+            append_varint(m_buffer, command.time_excess);
+            append_devices(m_buffer, command);
+            append_varint(m_buffer, command.quantum_length);
+            break;
+        case Command::Type::JobArrival:
+            m_buffer.push_back(JOB_ARRIVAL);
+            append_varint(m_buffer, command.time - m_previous_time);
+            append_varint(m_buffer, command.job_number);
+            append_varint(m_buffer, command.memory);
+            append_devices(m_buffer, command);
+            append_varint(m_buffer, command.runtime);
+            append_varint(m_buffer, command.priority);
+            break;
+        case Command::Type::DeviceRequest:
+        case Command::Type::DeviceRelease:
+            m_buffer.push_back((command.type == Command::Type::DeviceRequest) 
+                               ? DEVICE_REQUEST : DEVICE_RELEASE);
+            append_varint(m_buffer, command.time - m_previous_time);
+            append_varint(m_buffer, command.job_number);
+            append_devices(m_buffer, command);
+            break;
+        case Command::Type::Display:
+            m_buffer.push_back(DISPLAY);
+            append_varint(m_buffer, command.time - m_previous_time);
+            break;
+        case Command::Type::Unknown:
+            throw runtime_error("Error: Unknown input command cannot be converted.");
+    }
+    m_previous_time = command.time;
+    m_out.write(m_buffer.data(), m_buffer.size());
+}
+
+bool BinaryTraceReader::is_binary_trace(string_view input) {
+    return input.size() >= sizeof(MAGIC) && memcmp(input.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+BinaryTraceReader::BinaryTraceReader(string_view input) 
+: m_input(input), m_position(sizeof(MAGIC)), m_configuration(), 
+  m_configuration_read(false), m_previous_time(0) {
+    if (!is_binary_trace(input) || input.size() < VERSION_END) {
+        throw runtime_error("Error: Malformed binary trace.");
+    }
+    if (static_cast<uint32_t>(read_int32()) != VERSION) {
+        throw runtime_error("Error: Unsupported binary trace version.");
+    }
+    m_configuration.type = Command::Type::Configuration;
+    m_configuration.time = read_varint();
+    m_configuration.memory = read_varint();
+    m_configuration.time_excess = read_varint();
+    read_devices(m_configuration);
+    m_configuration.quantum_length = read_varint();
+    m_previous_time = m_configuration.time;
+}
+
+int BinaryTraceReader::read_int32() {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(m_input.data() + m_position);
+    uint32_t bits = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    m_position += 4;
+    return static_cast<int>(bits);
+}
+
+int BinaryTraceReader::read_varint() {
+    uint32_t bits = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (m_position >= m_input.size()) {
+            throw runtime_error("Error: Malformed binary trace.");
+        }
+        uint8_t byte = static_cast<uint8_t>(m_input[m_position++]);
+        bits |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            return static_cast<int>((bits >> 1) ^ (~(bits & 1) + 1));
+        }
+    }
+    throw runtime_error("Error: Malformed binary trace.");
+}
+
+void BinaryTraceReader::read_devices(Command& command) {
+    command.device_classes = read_varint();
+    if (command.device_classes < 1 || command.device_classes > DeviceVector::MAX_CLASSES) {
+        throw runtime_error("Error: Malformed binary trace.");
+    }
+    for (int i = 0; i < command.device_classes; i++) {
+        command.devices[i] = read_varint();
+    }
+}
+
+bool BinaryTraceReader::next(Command& command) {
+    if (!m_configuration_read) {
+        command = m_configuration;
+        m_configuration_read = true;
+        return true;
+    }
+    command = Command();
+    if (m_position >= m_input.size()) {
+        return false;
+    }
+    uint8_t type = static_cast<uint8_t>(m_input[m_position++]);
+    command.time = m_previous_time + read_varint();
+    m_previous_time = command.time;
+    switch (type) {
+        case CONFIGURATION:
+            command.type = Command::Type::Configuration;
+            command.memory = read_varint();
+            command.time_excess = read_varint();
+            read_devices(command);
+            command.quantum_length = read_varint();
+            break;
+        case JOB_ARRIVAL:
+            command.type = Command::Type::JobArrival;
+            command.job_number = read_varint();
+            command.memory = read_varint();
+            read_devices(command);
+            command.runtime = read_varint();
+            command.priority = read_varint();
+            break;
+        case DEVICE_REQUEST:
+        case DEVICE_RELEASE:
+            command.type = (type == DEVICE_REQUEST) ? Command::Type::DeviceRequest 
+                                                    : Command::Type::DeviceRelease;
+            command.job_number = read_varint();
+            read_devices(command);
+            break;
+        case DISPLAY:
+            command.type = Command::Type::Display;
+            break;
+        default:
+            throw runtime_error("Error: Malformed binary trace.");
+    }
+    return true;
+}
+
+size_t BinaryTraceReader::get_position() const {
+    return m_position;
+}
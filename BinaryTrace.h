@@ -0,0 +1,109 @@
+#ifndef _BINARY_TRACE_H_
+#define _BINARY_TRACE_H_
+
+#include <string_view>
+#include <string>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+#include "Command.h"
+
+/*
+ * Binary trace format (version 3, little-endian)
+ * 
+ * Header, holding the system configuration (the first command of a trace):
+ *   char[8]  magic "CS641TRC"
+ *   uint32   version
+ *   varint   time, memory, time_excess, devices, quantum_length
+ * 
+ * Then one record per further command:
+ *   uint8    type (0 = C, 1 = A, 2 = Q, 3 = L, 4 = D)
+ *   varint   time minus the time of the previous command
+ *   varint   fields of the command, in order:
+ *              C: memory, time_excess, devices, quantum_length
+ *              A: job_number, memory, devices, runtime, priority
+ *              Q, L: job_number, devices
+ *              D: none
+ *            where devices is the number of device classes followed by the 
+ *            count of each class
+ * 
+ * Varints are LEB128-encoded zigzag integers, so small negative values (such as 
+ * a trace going back in time) stay short.
+ */
+
+/**
+ * @class BinaryTraceWriter
+ * @brief Encodes Commands as a binary trace.
+ */
+class BinaryTraceWriter {
+public:
+    /**
+     * @brief Constructs a writer.
+     * @param out The stream to write to; must be opened in binary mode.
+     */
+    explicit BinaryTraceWriter(std::ostream& out);
+    
+    /**
+     * @brief Encodes a command.
+     * @param command The command to encode.
+     * @throws runtime_error if the first command is not a system configuration, 
+     * or the command is unknown.
+     */
+    void write(const Command& command);
+    
+private:
+    std::ostream& m_out;
+    bool m_header_written;
+    int m_previous_time;
+    std::string m_buffer;
+};
+
+/**
+ * @class BinaryTraceReader
+ * @brief Decodes Commands from a binary trace, in the same way as CommandParser.
+ */
+class BinaryTraceReader {
+public:
+    /**
+     * @brief Checks if an input starts with the binary trace magic.
+     * @param input The input.
+     * @return True if the input is a binary trace, false otherwise.
+     */
+    static bool is_binary_trace(std::string_view input);
+    
+    /**
+     * @brief Constructs a reader over the given input.
+     * @param input The input; must outlive the reader.
+     * @throws runtime_error if the header is missing, truncated or of another 
+     * version.
+     */
+    explicit BinaryTraceReader(std::string_view input);
+    
+    /**
+     * @brief Decodes the next command.
+     * @param command Set to the decoded command.
+     * @return False if there are no more commands, true otherwise.
+     * @throws runtime_error if the trace is truncated or malformed.
+     */
+    bool next(Command& command);
+    
+    /**
+     * @brief Gets the number of bytes consumed so far.
+     * @return The offset of the next record in the input.
+     */
+    std::size_t get_position() const;
+    
+private:
+    std::string_view m_input;
+    std::size_t m_position;
+    Command m_configuration; ///< The configuration of the header
+    bool m_configuration_read;
+    int m_previous_time;
+    
+    int read_int32();
+    int read_varint();
+    void read_devices(Command& command);
+};
+
+#endif // _BINARY_TRACE_H_
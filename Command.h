@@ -0,0 +1,45 @@
+#ifndef _COMMAND_H_
+#define _COMMAND_H_
+
+#include "DeviceVector.h"
+
+/**
+ * @struct Command
+ * @brief One decoded line of the input file.
+ * 
+ * Only the fields used by the command's type are meaningful:
+ * - Configuration: memory (M), time_excess (L), devices (S), quantum_length (Q)
+ * - JobArrival: job_number (J), memory (M), devices (S), runtime (R), priority (P)
+ * - DeviceRequest, DeviceRelease: job_number (J), devices (D)
+ * - Display, Unknown: none
+ * 
+ * Devices are given per device class as a comma-separated list (S=4,2,1); 
+ * device_classes is the length of the list.
+ */
+struct Command {
+    /**
+     * @enum Type
+     * @brief The command, given by the first character of the line.
+     */
+    enum class Type {
+        Configuration, ///< C
+        JobArrival,    ///< A
+        DeviceRequest, ///< Q
+        DeviceRelease, ///< L
+        Display,       ///< D
+        Unknown,       ///< Anything else
+    };
+    
+    Type type;
+    int time;
+    int memory;
+    int time_excess;
+    DeviceVector devices;
+    int device_classes;
+    int quantum_length;
+    int job_number;
+    int runtime;
+    int priority;
+};
+
+#endif // _COMMAND_H_
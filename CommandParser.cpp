@@ -0,0 +1,212 @@
+#include <stdexcept>
+#include <charconv>
+#include <cctype>
+
+#include "CommandParser.h"
+
+using namespace std;
+
+/**
+ * @brief Reads an integer prefix of a token the way atoi() does.
+ * 
+ * Leading whitespace and a '+' sign are skipped, parsing stops at the first 
+ * character that is not a digit, and a token without digits reads as 0.
+ */
+int parse_int(string_view s) {
+    size_t i = 0;
+    while (i < s.size() && isspace(static_cast<unsigned char>(s[i]))) {
+        i++;
+    }
+    if (i < s.size() && s[i] == '+') {
+        i++;
+    }
+    int value = 0;
+    if (from_chars(s.data() + i, s.data() + s.size(), value).ec != errc()) {
+        return 0;
+    }
+    return value;
+}
+
+/**
+ * @brief Splits the next space-delimited token off the front of a line.
+ * 
+ * A trailing space does not produce an empty final token, as with getline().
+ * 
+ * @param line The rest of the line; the token and its delimiter are removed.
+ * @param token Set to the token.
+ * @return False if the line is empty, true otherwise.
+ */
+bool next_token(string_view& line, string_view& token) {
+    if (line.empty()) {
+        return false;
+    }
+    size_t space = line.find(' ');
+    if (space == string_view::npos) {
+        token = line;
+        line = string_view();
+    } else {
+        token = line.substr(0, space);
+        line.remove_prefix(space + 1);
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a comma-separated list of device counts, one per device class.
+ * 
+ * Each count is read like an integer token, so "S=4" is one class with 4 devices.
+ * 
+ * @param s The value of the key.
+ * @param devices Set to the counts; classes not in the list are 0.
+ * @return The number of classes in the list.
+ * @throws runtime_error if there are more than DeviceVector::MAX_CLASSES counts.
+ */
+int parse_devices(string_view s, DeviceVector& devices) {
+    int classes = 0;
+    while (true) {
+        if (classes == DeviceVector::MAX_CLASSES) {
+            throw runtime_error("Error: Too many device classes");
+        }
+        size_t comma = s.find(',');
+        devices[classes++] = parse_int(s.substr(0, comma));
+        if (comma == string_view::npos) {
+            return classes;
+        }
+        s.remove_prefix(comma + 1);
+    }
+}
+
+// Bits of Command fields that have been set by a key
+enum FieldBit {
+    MEMORY = 1 << 0,
+    TIME_EXCESS = 1 << 1,
+    DEVICES = 1 << 2,
+    QUANTUM_LENGTH = 1 << 3,
+    JOB_NUMBER = 1 << 4,
+    RUNTIME = 1 << 5,
+    PRIORITY = 1 << 6,
+};
+
+/**
+ * @brief Stores the value of a key in the field it means for the command's type.
+ * @return The bit of the field that was set, or 0 if the key is ignored.
+ */
+int set_field(Command& command, char key, string_view value, int present) {
+    int* field = nullptr;
+    int bit = 0;
+    switch (command.type) {
+        case Command::Type::Configuration:
+            switch (key) {
+                case 'M': field = &command.memory; bit = MEMORY; break;
+                case 'L': field = &command.time_excess; bit = TIME_EXCESS; break;
+                case 'S': bit = DEVICES; break;
+                case 'Q': field = &command.quantum_length; bit = QUANTUM_LENGTH; break;
+            }
+            break;
+        case Command::Type::JobArrival:
+            switch (key) {
+                case 'J': field = &command.job_number; bit = JOB_NUMBER; break;
+                case 'M': field = &command.memory; bit = MEMORY; break;
+                case 'S': bit = DEVICES; break;
+                case 'R': field = &command.runtime; bit = RUNTIME; break;
+                case 'P': field = &command.priority; bit = PRIORITY; break;
+            }
+            break;
+        case Command::Type::DeviceRequest:
+        case Command::Type::DeviceRelease:
+            switch (key) {
+                case 'J': field = &command.job_number; bit = JOB_NUMBER; break;
+                case 'D': bit = DEVICES; break;
+            }
+            break;
+        default:
+            break;
+    }
+    if (bit == 0 || (present & bit)) {
+        // Unknown keys are ignored, and the first occurrence of a key wins
+        return 0;
+    }
+    if (bit == DEVICES) {
+        command.device_classes = parse_devices(value, command.devices);
+    } else {
+        *field = parse_int(value);
+    }
+    return bit;
+}
+
+CommandParser::CommandParser(string_view input) 
+: m_input(input), m_position(0) {
+}
+
+bool CommandParser::next(Command& command) {
+    if (m_position >= m_input.size()) {
+        return false;
+    }
+    string_view rest = m_input.substr(m_position);
+    size_t newline = rest.find('\n');
+    string_view line = rest.substr(0, newline);
+    m_position += (newline == string_view::npos) ? rest.size() : newline + 1;
+    command = parse_line(line);
+    return true;
+}
+
+Command CommandParser::parse_line(string_view line) {
+    string_view type_token;
+    string_view time_token;
+    if (!next_token(line, type_token) || !next_token(line, time_token)) {
+        throw runtime_error("Error: Malformed input line");
+    }
+    
+    Command command = Command();
+    command.time = parse_int(time_token);
+    int required = 0;
+    if (type_token.size() != 1) {
+        command.type = Command::Type::Unknown;
+    } else {
+        switch (type_token[0]) {
+            case 'C': 
+                command.type = Command::Type::Configuration; 
+                required = MEMORY | TIME_EXCESS | DEVICES | QUANTUM_LENGTH;
+                break;
+            case 'A': 
+                command.type = Command::Type::JobArrival; 
+                required = JOB_NUMBER | MEMORY | DEVICES | RUNTIME | PRIORITY;
+                break;
+            case 'Q': 
+                command.type = Command::Type::DeviceRequest; 
+                required = JOB_NUMBER | DEVICES;
+                break;
+            case 'L': 
+                command.type = Command::Type::DeviceRelease; 
+                required = JOB_NUMBER | DEVICES;
+                break;
+            case 'D': 
+                command.type = Command::Type::Display; 
+                break;
+            default: 
+                command.type = Command::Type::Unknown; 
+                break;
+        }
+    }
+    if (required == 0) {
+        // Displays and unknown commands have no parameters to check
+        return command;
+    }
+    
+    int present = 0;
+    string_view token;
+    while (next_token(line, token)) {
+        if (token.size() < 3) {
+            throw runtime_error("Error: Malformed input line");
+        }
+        present |= set_field(command, token[0], token.substr(2), present);
+    }
+    if ((present & required) != required) {
+        throw runtime_error("Error: Malformed input line");
+    }
+    return command;
+}
+
+size_t CommandParser::get_position() const {
+    return m_position;
+}
@@ -0,0 +1,57 @@
+#ifndef _COMMAND_PARSER_H_
+#define _COMMAND_PARSER_H_
+
+#include <string_view>
+#include <cstddef>
+
+#include "Command.h"
+
+/**
+ * @class CommandParser
+ * @brief Decodes input lines into Commands without allocating.
+ * 
+ * The parser walks a view of the whole input (normally a MappedFile) and slices 
+ * lines and tokens out of it as string_views. A line is "<type> <time>" followed 
+ * by "<key>=<value>" tokens, separated by single spaces; numbers are read with 
+ * std::from_chars. Parsing matches the istringstream/atoi parser it replaced: 
+ * a carriage return before the newline stays in the last token, the first 
+ * occurrence of a key wins, unknown keys are ignored, and a number is read from 
+ * the longest numeric prefix of a value (0 if there is none). Device counts are 
+ * comma-separated lists of such numbers, one per device class.
+ */
+class CommandParser {
+public:
+    /**
+     * @brief Constructs a parser over the given input.
+     * @param input The input; must outlive the parser.
+     */
+    explicit CommandParser(std::string_view input);
+    
+    /**
+     * @brief Decodes the next line.
+     * @param command Set to the decoded line.
+     * @return False if there are no more lines, true otherwise.
+     * @throws runtime_error if the line is malformed.
+     */
+    bool next(Command& command);
+    
+    /**
+     * @brief Decodes a single line, without its line terminator.
+     * @param line The line to decode.
+     * @return The decoded line.
+     * @throws runtime_error if the line is malformed.
+     */
+    static Command parse_line(std::string_view line);
+    
+    /**
+     * @brief Gets the number of bytes consumed so far.
+     * @return The offset of the next line in the input.
+     */
+    std::size_t get_position() const;
+    
+private:
+    std::string_view m_input;
+    std::size_t m_position;
+};
+
+#endif // _COMMAND_PARSER_H_
@@ -0,0 +1,143 @@
+#include "DeviceNeedIndex.h"
+
+using namespace std;
+
+DeviceNeedIndex::DeviceNeedIndex(int device_classes) 
+: m_device_classes(device_classes), m_classes_mask((1u << device_classes) - 1), 
+  m_entries(), m_active(), m_active_position(), m_count(), m_need(), m_allocation(), 
+  m_unfinished() {
+}
+
+void DeviceNeedIndex::grow(int job_id) {
+    if (job_id >= (int) m_count.size()) {
+        m_active_position.resize(job_id + 1, 0);
+        m_count.resize(job_id + 1, 0);
+        m_need.resize(job_id + 1);
+        m_allocation.resize(job_id + 1);
+    }
+}
+
+void DeviceNeedIndex::add(int job_id, const DeviceVector& need, const DeviceVector& allocation) {
+    grow(job_id);
+    if (m_count[job_id] == 0) {
+        m_need[job_id] = need;
+        if (m_device_classes == 1) {
+            m_entries.insert({ need[0], job_id });
+        } else {
+            m_active_position[job_id] = m_active.size();
+            m_active.push_back(job_id);
+        }
+    }
+    m_allocation[job_id] = allocation;
+    m_count[job_id]++;
+}
+
+void DeviceNeedIndex::remove(int job_id) {
+    m_count[job_id]--;
+    if (m_count[job_id] == 0) {
+        if (m_device_classes == 1) {
+            m_entries.erase({ m_need[job_id][0], job_id });
+        } else {
+            // The order of m_active does not matter, so the last slot fills the gap
+            int last = m_active.back();
+            m_active[m_active_position[job_id]] = last;
+            m_active_position[last] = m_active_position[job_id];
+            m_active.pop_back();
+        }
+    }
+}
+
+void DeviceNeedIndex::update(int job_id, const DeviceVector& need, 
+                             const DeviceVector& allocation) {
+    grow(job_id);
+    if (m_device_classes == 1 && m_count[job_id] > 0 && m_need[job_id][0] != need[0]) {
+        m_entries.erase({ m_need[job_id][0], job_id });
+        m_entries.insert({ need[0], job_id });
+    }
+    m_need[job_id] = need;
+    m_allocation[job_id] = allocation;
+}
+
+bool DeviceNeedIndex::is_safe(int requester, const DeviceVector& request, 
+                              const DeviceVector& available, bool inclusive) const {
+    if (m_device_classes == 1) {
+        return is_safe_sorted(requester, request, available, inclusive);
+    }
+    return is_safe_any_order(requester, request, available, inclusive);
+}
+
+bool DeviceNeedIndex::is_safe_sorted(int requester, const DeviceVector& request, 
+                                     const DeviceVector& available, bool inclusive) const {
+    int work = available[0] - request[0];
+    // One entry of the requester is replaced by its state after the request, 
+    // which is visited at its place in need order
+    int requester_need = m_need[requester][0] - request[0];
+    int requester_allocation = m_allocation[requester][0] + request[0];
+    bool requester_pending = true;
+    
+    for (const pair<int, int>& entry : m_entries) {
+        int need = entry.first;
+        int job_id = entry.second;
+        if (requester_pending && requester_need <= need) {
+            if (inclusive ? requester_need > work : requester_need >= work) {
+                return false;
+            }
+            work += requester_allocation;
+            requester_pending = false;
+        }
+        int count = m_count[job_id] - ((job_id == requester) ? 1 : 0);
+        if (count > 0) {
+            if (inclusive ? need > work : need >= work) {
+                return false;
+            }
+            work += m_allocation[job_id][0] * count;
+        }
+    }
+    if (requester_pending) {
+        if (inclusive ? requester_need > work : requester_need >= work) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DeviceNeedIndex::is_safe_any_order(int requester, const DeviceVector& request, 
+                                        const DeviceVector& available, 
+                                        bool inclusive) const {
+    DeviceVector work = available - request;
+    DeviceVector requester_need = m_need[requester] - request;
+    DeviceVector requester_allocation = m_allocation[requester] + request;
+    bool requester_pending = true;
+    
+    m_unfinished.clear();
+    for (int job_id : m_active) {
+        if (m_count[job_id] - ((job_id == requester) ? 1 : 0) > 0) {
+            m_unfinished.push_back(job_id);
+        }
+    }
+    
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        if (requester_pending && requester_need.fits(work, m_classes_mask, inclusive)) {
+            work += requester_allocation;
+            requester_pending = false;
+            progress = true;
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < m_unfinished.size(); i++) {
+            int job_id = m_unfinished[i];
+            if (m_need[job_id].fits(work, m_classes_mask, inclusive)) {
+                int count = m_count[job_id] - ((job_id == requester) ? 1 : 0);
+                for (int c = 0; c < count; c++) {
+                    work += m_allocation[job_id];
+                }
+                progress = true;
+            } else {
+                m_unfinished[kept++] = job_id;
+            }
+        }
+        m_unfinished.resize(kept);
+    }
+    return !requester_pending && m_unfinished.empty();
+}
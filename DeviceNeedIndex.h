@@ -0,0 +1,94 @@
+#ifndef _DEVICE_NEED_INDEX_H_
+#define _DEVICE_NEED_INDEX_H_
+
+#include <set>
+#include <vector>
+#include <utility>
+
+#include "DeviceVector.h"
+
+/**
+ * @class DeviceNeedIndex
+ * @brief Keeps the active jobs (on the CPU, ready or waiting for devices) and their 
+ * remaining device need, for the banker's safety check.
+ * 
+ * Without negative allocations, finishing a job in the banker's safety algorithm 
+ * only adds to the available devices, so the order in which jobs are finished does 
+ * not change the result. With a single device class the jobs are kept sorted by 
+ * need: if the job with the smallest need cannot finish, none can, and is_safe() 
+ * makes one pass over the sorted jobs. With several classes there is no such 
+ * order, and is_safe() instead makes passes over the unfinished jobs, finishing 
+ * every job that fits, until a pass finishes none; each Need row is compared 
+ * against Work as a whole DeviceVector. Neither check allocates once the index 
+ * has grown to the number of jobs.
+ * 
+ * A job can be in the active set more than once (for example twice in the ready 
+ * queue), and counts once per entry, as it does in the textbook algorithm.
+ */
+class DeviceNeedIndex {
+public:
+    /**
+     * @brief Constructs an empty index.
+     * @param device_classes The number of configured device classes.
+     */
+    explicit DeviceNeedIndex(int device_classes);
+    
+    /**
+     * @brief Adds an entry of a job to the active set.
+     * @param job_id The slot of the job.
+     * @param need The devices the job may still request.
+     * @param allocation The devices allocated to the job.
+     */
+    void add(int job_id, const DeviceVector& need, const DeviceVector& allocation);
+    
+    /**
+     * @brief Removes an entry of a job from the active set.
+     * @param job_id The slot of the job.
+     */
+    void remove(int job_id);
+    
+    /**
+     * @brief Updates the need and allocation of a job after devices changed hands.
+     * @param job_id The slot of the job.
+     * @param need The devices the job may still request.
+     * @param allocation The devices allocated to the job.
+     */
+    void update(int job_id, const DeviceVector& need, const DeviceVector& allocation);
+    
+    /**
+     * @brief Runs the safety algorithm as if a request of an active job were granted.
+     * 
+     * The request must already have passed the resource request checks (at most 
+     * the requester's need and the available devices), and no allocation, even 
+     * after the request, may be negative.
+     * 
+     * @param requester The slot of the requesting job; one of its entries takes 
+     * the request.
+     * @param request The devices requested.
+     * @param available The available devices before the request.
+     * @param inclusive Whether a job can finish when its need equals the available 
+     * devices (Need <= Work) rather than only when it is less (Need < Work).
+     * @return True if the resulting state is safe, false otherwise.
+     */
+    bool is_safe(int requester, const DeviceVector& request, const DeviceVector& available, 
+                 bool inclusive) const;
+    
+private:
+    int m_device_classes;
+    unsigned int m_classes_mask;             ///< Bits of the configured classes
+    std::set<std::pair<int, int>> m_entries; ///< (need, slot) of each active job, single class
+    std::vector<int> m_active;               ///< Slots of the active jobs, several classes
+    std::vector<int> m_active_position;      ///< Index of each slot in m_active
+    std::vector<int> m_count;                ///< Entries of each slot in the active set
+    std::vector<DeviceVector> m_need;
+    std::vector<DeviceVector> m_allocation;
+    mutable std::vector<int> m_unfinished;   ///< Scratch space of is_safe_any_order()
+    
+    void grow(int job_id);
+    bool is_safe_sorted(int requester, const DeviceVector& request, 
+                        const DeviceVector& available, bool inclusive) const;
+    bool is_safe_any_order(int requester, const DeviceVector& request, 
+                           const DeviceVector& available, bool inclusive) const;
+};
+
+#endif // _DEVICE_NEED_INDEX_H_
@@ -4,11 +4,12 @@
 
 #include "DeviceReleaseEvent.h"
 #include "SystemState.h"
+#include "Trace.h"
 
 using namespace std;
 
 DeviceReleaseEvent::DeviceReleaseEvent(int time, int job_number, 
-                                       int released_devices)
+                                       const DeviceVector& released_devices)
 : Event(time), m_job_number(job_number), 
   m_released_devices(released_devices) {
 }
@@ -24,17 +25,26 @@ DeviceReleaseEvent::DeviceReleaseEvent(int time, int job_number,
  * @param state The system state object.
  */
 void DeviceReleaseEvent::process(SystemState& state) {
-    cout << get_time() << ": Release for devices" << endl;
-    if (state.cpu_get_job() != m_job_number) {
+    handle(state, get_time(), m_job_number, m_released_devices);
+}
+
+void DeviceReleaseEvent::handle(SystemState& state, int time, int job_number, 
+                                const DeviceVector& released_devices) {
+    TRACE(TraceLevel::Events, time << ": Release for devices");
+    if (state.cpu_get_job_number() != job_number) {
         cerr << " Error: Job attempted to release devices while not on the CPU"
              << endl;
         return;
     }
     
-    state.cpu_release_devices(m_released_devices);
+    state.cpu_release_devices(released_devices);
     state.end_quantum();
 }
 
 Event::Type DeviceReleaseEvent::get_type() const {
     return Event::Type::External;
 }
+
+Event::Kind DeviceReleaseEvent::get_kind() const {
+    return Event::Kind::DeviceRelease;
+}
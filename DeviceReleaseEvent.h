@@ -20,7 +20,7 @@ public:
      * @param job_number The number of the job that releases the devices.
      * @param released_devices The number of devices released by the job.
      */
-    DeviceReleaseEvent(int time, int job_number, int released_devices);
+    DeviceReleaseEvent(int time, int job_number, const DeviceVector& released_devices);
     
     /**
      * @brief Processes the device release event and updates the system state accordingly.
@@ -29,6 +29,16 @@ public:
      */
     void process(SystemState& state);
     
+    /**
+     * @brief Handles a device release; shared by DeviceReleaseEvent and DeviceReleaseRecord.
+     * @param state The current system state.
+     * @param time The time at which the event occurs.
+     * @param job_number The number of the job that releases the devices.
+     * @param released_devices The number of devices released by the job.
+     */
+    static void handle(SystemState& state, int time, int job_number, 
+                       const DeviceVector& released_devices);
+    
     /**
      * @brief Returns the type of the event.
      * 
@@ -36,9 +46,15 @@ public:
      */
     Type get_type() const;
     
+    /**
+     * @brief Gets the kind of the event.
+     * @return Kind::DeviceRelease.
+     */
+    Kind get_kind() const;
+    
 private:
     int m_job_number; ///< The number of the job that releases the devices.
-    int m_released_devices; ///< The number of devices released by the job.
+    DeviceVector m_released_devices; ///< The number of devices released by the job.
 };
 
 #endif // _DEVICE_RELEASE_EVENT_H_
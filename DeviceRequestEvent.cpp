@@ -4,11 +4,12 @@
 
 #include "DeviceRequestEvent.h"
 #include "SystemState.h"
+#include "Trace.h"
 
 using namespace std;
 
 DeviceRequestEvent::DeviceRequestEvent(int time, int job_number, 
-                                       int requested_devices)
+                                       const DeviceVector& requested_devices)
 : Event(time), m_job_number(job_number), 
   m_requested_devices(requested_devices) {
 }
@@ -20,16 +21,25 @@ DeviceRequestEvent::DeviceRequestEvent(int time, int job_number,
  * @param state The reference to the SystemState object representing the current system state.
  */
 void DeviceRequestEvent::process(SystemState& state) {
-    cout << get_time() << ": Request for devices" << endl;
-    if (state.cpu_get_job() != m_job_number) {
+    handle(state, get_time(), m_job_number, m_requested_devices);
+}
+
+void DeviceRequestEvent::handle(SystemState& state, int time, int job_number, 
+                                const DeviceVector& requested_devices) {
+    TRACE(TraceLevel::Events, time << ": Request for devices");
+    if (state.cpu_get_job_number() != job_number) {
         cerr << " Error: Job requested devices while not on the CPU" << endl;
         return;
     }
     
-    state.cpu_request_devices(m_requested_devices);
+    state.cpu_request_devices(requested_devices);
     state.end_quantum();
 }
 
 Event::Type DeviceRequestEvent::get_type() const {
     return Event::Type::External;
 }
+
+Event::Kind DeviceRequestEvent::get_kind() const {
+    return Event::Kind::DeviceRequest;
+}
@@ -21,7 +21,7 @@ public:
      * @param job_number The number of the job making the device request.
      * @param requested_devices The number of devices requested by the job.
      */
-    DeviceRequestEvent(int time, int job_number, int requested_devices);
+    DeviceRequestEvent(int time, int job_number, const DeviceVector& requested_devices);
     
     /**
      * @brief Processes the device request event and updates the system state accordingly.
@@ -29,15 +29,31 @@ public:
      */
     void process(SystemState& state);
     
+    /**
+     * @brief Handles a device request; shared by DeviceRequestEvent and DeviceRequestRecord.
+     * @param state The current system state.
+     * @param time The time at which the event occurs.
+     * @param job_number The number of the job that requests the devices.
+     * @param requested_devices The number of devices requested by the job.
+     */
+    static void handle(SystemState& state, int time, int job_number, 
+                       const DeviceVector& requested_devices);
+    
     /**
      * @brief Gets the type of the event.
      * @return The type of the event.
      */
     Type get_type() const;
     
+    /**
+     * @brief Gets the kind of the event.
+     * @return Kind::DeviceRequest.
+     */
+    Kind get_kind() const;
+    
 private:
     int m_job_number; ///< The number of the job making the device request.
-    int m_requested_devices; ///< The number of devices requested by the job.
+    DeviceVector m_requested_devices; ///< The number of devices requested by the job.
 };
 
 #endif // _DEVICE_REQUEST_EVENT_H_
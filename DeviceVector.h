@@ -0,0 +1,152 @@
+#ifndef _DEVICE_VECTOR_H_
+#define _DEVICE_VECTOR_H_
+
+#include <cstdint>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * @class DeviceVector
+ * @brief A count of devices of each device class (tape drives, licenses, ...).
+ *
+ * The width is fixed at MAX_CLASSES, whatever the number of classes configured,
+ * and classes that are not configured hold 0. The banker's algorithm compares
+ * and adds whole vectors, four classes per SSE2 instruction where available.
+ */
+class DeviceVector {
+public:
+    static constexpr int MAX_CLASSES = 16;
+
+    DeviceVector() : m_count() {
+    }
+
+    /**
+     * @brief Constructs a vector with devices of the first class only.
+     * @param devices The number of devices of the first class.
+     */
+    explicit DeviceVector(int devices) : m_count() {
+        m_count[0] = devices;
+    }
+
+    int operator[](int device_class) const { return m_count[device_class]; }
+    int& operator[](int device_class) { return m_count[device_class]; }
+
+    DeviceVector& operator+=(const DeviceVector& other) {
+#ifdef __SSE2__
+        for (int i = 0; i < MAX_CLASSES; i += 4) {
+            store(i, _mm_add_epi32(load(i), other.load(i)));
+        }
+#else
+        for (int i = 0; i < MAX_CLASSES; i++) {
+            m_count[i] += other.m_count[i];
+        }
+#endif
+        return *this;
+    }
+
+    DeviceVector& operator-=(const DeviceVector& other) {
+#ifdef __SSE2__
+        for (int i = 0; i < MAX_CLASSES; i += 4) {
+            store(i, _mm_sub_epi32(load(i), other.load(i)));
+        }
+#else
+        for (int i = 0; i < MAX_CLASSES; i++) {
+            m_count[i] -= other.m_count[i];
+        }
+#endif
+        return *this;
+    }
+
+    friend DeviceVector operator+(DeviceVector a, const DeviceVector& b) { return a += b; }
+    friend DeviceVector operator-(DeviceVector a, const DeviceVector& b) { return a -= b; }
+
+    /**
+     * @brief Gets the classes in which this vector has more devices than another.
+     * @return A mask with bit i set if (*this)[i] > other[i].
+     */
+    unsigned int greater_mask(const DeviceVector& other) const {
+#ifdef __SSE2__
+        unsigned int mask = 0;
+        for (int i = 0; i < MAX_CLASSES; i += 4) {
+            __m128i gt = _mm_cmpgt_epi32(load(i), other.load(i));
+            mask |= static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(gt))) << i;
+        }
+        return mask;
+#else
+        unsigned int mask = 0;
+        for (int i = 0; i < MAX_CLASSES; i++) {
+            mask |= static_cast<unsigned int>(m_count[i] > other.m_count[i]) << i;
+        }
+        return mask;
+#endif
+    }
+
+    /**
+     * @brief Gets the classes in which this vector has as many devices as another.
+     * @return A mask with bit i set if (*this)[i] == other[i].
+     */
+    unsigned int equal_mask(const DeviceVector& other) const {
+#ifdef __SSE2__
+        unsigned int mask = 0;
+        for (int i = 0; i < MAX_CLASSES; i += 4) {
+            __m128i eq = _mm_cmpeq_epi32(load(i), other.load(i));
+            mask |= static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(eq))) << i;
+        }
+        return mask;
+#else
+        unsigned int mask = 0;
+        for (int i = 0; i < MAX_CLASSES; i++) {
+            mask |= static_cast<unsigned int>(m_count[i] == other.m_count[i]) << i;
+        }
+        return mask;
+#endif
+    }
+
+    bool operator==(const DeviceVector& other) const {
+        return equal_mask(other) == (1u << MAX_CLASSES) - 1;
+    }
+    bool operator!=(const DeviceVector& other) const { return !(*this == other); }
+
+    /** @brief Checks if any class has more devices than in another vector. */
+    bool any_greater(const DeviceVector& other) const { return greater_mask(other) != 0; }
+
+    /** @brief Checks if any class has a positive count. */
+    bool any_positive() const { return any_greater(DeviceVector()); }
+
+    /** @brief Checks if any class has a negative count. */
+    bool any_negative() const { return DeviceVector().any_greater(*this); }
+
+    /**
+     * @brief Checks if a job with this need can finish with the given work in the
+     * banker's safety algorithm.
+     *
+     * Need <= Work must hold in every class. Unless inclusive, Need < Work must
+     * also hold in each of the configured classes, as in the single-class check.
+     *
+     * @param work The available devices.
+     * @param classes_mask A mask of the configured classes.
+     * @param inclusive Whether Need == Work is enough in the configured classes.
+     */
+    bool fits(const DeviceVector& work, unsigned int classes_mask, bool inclusive) const {
+        if (greater_mask(work) != 0) {
+            return false;
+        }
+        return inclusive || (equal_mask(work) & classes_mask) == 0;
+    }
+
+private:
+#ifdef __SSE2__
+    __m128i load(int i) const {
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(m_count + i));
+    }
+    void store(int i, __m128i value) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(m_count + i), value);
+    }
+#endif
+
+    alignas(16) std::int32_t m_count[MAX_CLASSES];
+};
+
+#endif // _DEVICE_VECTOR_H_
@@ -2,9 +2,11 @@
 #include <stdexcept>
 #include <vector>
 #include <fstream>
+#include <chrono>
 
 #include "DisplayEvent.h"
 #include "SystemState.h"
+#include "SnapshotWriter.h"
 
 using namespace std;
 
@@ -17,18 +19,31 @@ DisplayEvent::DisplayEvent(int time, string filename)
  * @param state The current system state.
  */
 void DisplayEvent::process(SystemState& state) {
-    cout << get_time() << ": Display system status" << endl;
-    bool include_system_turnaround = get_time() == END_TIME;
-    // Print text output to console
-    cout << state.to_text(include_system_turnaround) << endl;
-    // Write json output to file
-    string out_filename = m_filename + "_D" + to_string(get_time()) + ".json";
-    ofstream out_file;
-    out_file.open(out_filename);
-    out_file << state.to_json(include_system_turnaround);
-    out_file.close();
+    handle(state, get_time(), m_filename);
+}
+
+void DisplayEvent::handle(SystemState& state, int time, const string& filename) {
+    cout << time << ": Display system status" << endl;
+    bool include_system_turnaround = time == END_TIME;
+    string out_filename = filename + "_D" + to_string(time) + ".json";
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    SnapshotWriter* writer = state.get_snapshot_writer();
+    if (writer != nullptr) {
+        // The writer thread prints the text output and writes the json file
+        writer->submit(state, out_filename, include_system_turnaround);
+    } else {
+        // Print text output to console and write json output to file
+        DisplaySnapshot& snapshot = state.get_display_snapshot();
+        state.capture_display(snapshot, include_system_turnaround);
+        state.get_display_writer().write(snapshot, cout, out_filename);
+    }
+    state.record_display_time(chrono::steady_clock::now() - start);
 }
 
 Event::Type DisplayEvent::get_type() const {
     return Event::Type::External;
 }
+
+Event::Kind DisplayEvent::get_kind() const {
+    return Event::Kind::Display;
+}
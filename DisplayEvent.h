@@ -30,12 +30,26 @@ public:
      */
     void process(SystemState& state);
     
+    /**
+     * @brief Handles a display; shared by DisplayEvent and DisplayRecord.
+     * @param state The current system state.
+     * @param time The time at which the display event occurs.
+     * @param filename The name of the file to which the system state will be displayed.
+     */
+    static void handle(SystemState& state, int time, const std::string& filename);
+    
     /**
      * @brief Returns the type of the event.
      * @return The type of the event (DISPLAY).
      */
     Type get_type() const;
     
+    /**
+     * @brief Gets the kind of the event.
+     * @return Kind::Display.
+     */
+    Kind get_kind() const;
+    
 private:
     std::string m_filename; /**< The name of the file to which the system state will be displayed. */
 };
@@ -0,0 +1,333 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <stdexcept>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <iterator>
+
+#include "MappedFile.h"
+
+using namespace std;
+
+/**
+ * A value of a display JSON file. Numbers and other scalars are kept as their
+ * text, so they are written back exactly as they were read.
+ */
+struct JsonValue {
+    enum class Kind { Object, Array, Scalar };
+    
+    Kind kind = Kind::Scalar;
+    string text;
+    vector<pair<string, JsonValue>> members;
+    vector<JsonValue> items;
+    
+    const JsonValue* find(const string& name) const {
+        for (const pair<string, JsonValue>& member : members) {
+            if (member.first == name) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+    
+    JsonValue* find(const string& name) {
+        return const_cast<JsonValue*>(static_cast<const JsonValue&>(*this).find(name));
+    }
+};
+
+/**
+ * Parses the JSON written by DisplayWriter: objects, arrays, strings without
+ * escapes, and scalars (which may be nan or inf, so they are not checked).
+ */
+class JsonParser {
+public:
+    JsonParser(string_view text, const string& filename)
+    : m_text(text), m_position(0), m_filename(filename) {
+    }
+    
+    JsonValue parse() {
+        JsonValue value = parse_value();
+        skip_space();
+        if (m_position != m_text.size()) {
+            fail();
+        }
+        return value;
+    }
+
+private:
+    string_view m_text;
+    size_t m_position;
+    const string& m_filename;
+    
+    [[noreturn]] void fail() const {
+        throw runtime_error("Error: Malformed display file " + m_filename
+                            + " at byte " + to_string(m_position));
+    }
+    
+    void skip_space() {
+        while (m_position < m_text.size() && isspace((unsigned char) m_text[m_position])) {
+            m_position++;
+        }
+    }
+    
+    bool consume(char c) {
+        skip_space();
+        if (m_position < m_text.size() && m_text[m_position] == c) {
+            m_position++;
+            return true;
+        }
+        return false;
+    }
+    
+    void expect(char c) {
+        if (!consume(c)) {
+            fail();
+        }
+    }
+    
+    string parse_string() {
+        expect('"');
+        size_t end = m_text.find('"', m_position);
+        if (end == string_view::npos) {
+            fail();
+        }
+        string text(m_text.substr(m_position, end - m_position));
+        m_position = end + 1;
+        return text;
+    }
+    
+    JsonValue parse_value() {
+        JsonValue value;
+        skip_space();
+        if (consume('{')) {
+            value.kind = JsonValue::Kind::Object;
+            if (!consume('}')) {
+                do {
+                    string name = parse_string();
+                    expect(':');
+                    value.members.emplace_back(name, parse_value());
+                } while (consume(','));
+                expect('}');
+            }
+        } else if (consume('[')) {
+            value.kind = JsonValue::Kind::Array;
+            if (!consume(']')) {
+                do {
+                    value.items.push_back(parse_value());
+                } while (consume(','));
+                expect(']');
+            }
+        } else {
+            size_t start = m_position;
+            while (m_position < m_text.size()
+                   && string_view(",]} \t\r\n").find(m_text[m_position]) == string_view::npos) {
+                m_position++;
+            }
+            if (m_position == start) {
+                fail();
+            }
+            value.text = string(m_text.substr(start, m_position - start));
+        }
+        return value;
+    }
+};
+
+JsonValue read_display(const string& filename) {
+    MappedFile file(filename);
+    return JsonParser(file.contents(), filename).parse();
+}
+
+/**
+ * Writes a value in the layout of the simulator's JSON files.
+ */
+void write_json(ostream& out, const JsonValue& value) {
+    switch (value.kind) {
+        case JsonValue::Kind::Object:
+            out << "{";
+            for (size_t i = 0; i < value.members.size(); i++) {
+                if (i != 0) {
+                    out << ", ";
+                }
+                // The simulator has always written this member this way
+                out << "\"" << value.members[i].first
+                    << ((value.members[i].first == "running") ? "\" :" : "\": ");
+                write_json(out, value.members[i].second);
+            }
+            out << "}";
+            break;
+        case JsonValue::Kind::Array:
+            out << "[";
+            for (size_t i = 0; i < value.items.size(); i++) {
+                if (i != 0) {
+                    out << ", ";
+                }
+                write_json(out, value.items[i]);
+            }
+            out << "]";
+            break;
+        case JsonValue::Kind::Scalar:
+            out << value.text;
+            break;
+    }
+}
+
+/**
+ * Applies the change of a queue: a full array replaces the queue, and
+ * {"drop": k, "append": [...]} removes k jobs from its front and adds jobs to
+ * its back.
+ */
+void apply_queue_edit(JsonValue& queue, const JsonValue& edit) {
+    if (edit.kind == JsonValue::Kind::Array) {
+        queue = edit;
+        return;
+    }
+    const JsonValue* drop = edit.find("drop");
+    const JsonValue* append = edit.find("append");
+    if (drop == nullptr || append == nullptr) {
+        throw runtime_error("Error: Malformed queue change in display file.");
+    }
+    size_t count = strtoul(drop->text.c_str(), nullptr, 10);
+    if (count > queue.items.size()) {
+        throw runtime_error("Error: Queue change drops more jobs than the queue holds.");
+    }
+    queue.items.erase(queue.items.begin(), queue.items.begin() + count);
+    queue.items.insert(queue.items.end(), append->items.begin(), append->items.end());
+}
+
+const string& job_id(const JsonValue& job) {
+    const JsonValue* id = job.find("id");
+    if (id == nullptr) {
+        throw runtime_error("Error: Job without an id in display file.");
+    }
+    return id->text;
+}
+
+/**
+ * Applies a delta display to the full display before it, giving the full display 
+ * in the layout written by the simulator. Changed jobs keep their place in the 
+ * job list and new jobs are added at its end, so the jobs may be listed in 
+ * another order than in a full display written at the same time.
+ */
+void apply_delta(JsonValue& display, const JsonValue& delta) {
+    const char* const MEMBERS[] = {
+        "readyq", "current_time", "total_memory", "available_memory", "total_devices", 
+        "running", "submitq", "longq", "holdq2", "job", "holdq1", "available_devices", 
+        "quantum", "completeq", "waitq", "retired", "latency", "turnaround", 
+        "weighted_turnaround", "turnaround_stddev", "weighted_turnaround_stddev"
+    };
+    const char* const QUEUES[] = { "readyq", "longq", "holdq2", "holdq1", "completeq", "waitq" };
+    
+    JsonValue full;
+    full.kind = JsonValue::Kind::Object;
+    for (const char* name : MEMBERS) {
+        JsonValue* base = display.find(name);
+        const JsonValue* change = delta.find(name);
+        if (string(name) == "job" || string(name) == "submitq") {
+            // Updated below, or always empty
+            if (base != nullptr) {
+                full.members.emplace_back(name, move(*base));
+            }
+        } else if (change == nullptr) {
+            // Members after the queues are only present in some displays
+            continue;
+        } else if (find(begin(QUEUES), end(QUEUES), string(name)) != end(QUEUES)) {
+            if (base == nullptr) {
+                throw runtime_error("Error: Queue change without a queue in display file.");
+            }
+            apply_queue_edit(*base, *change);
+            full.members.emplace_back(name, move(*base));
+        } else {
+            full.members.emplace_back(name, *change);
+        }
+    }
+    
+    // Jobs
+    JsonValue* jobs = full.find("job");
+    if (jobs == nullptr) {
+        throw runtime_error("Error: Display file without a job list.");
+    }
+    if (const JsonValue* removed_jobs = delta.find("removed_jobs")) {
+        if (!removed_jobs->items.empty()) {
+            unordered_set<string> removed;
+            for (const JsonValue& id : removed_jobs->items) {
+                removed.insert(id.text);
+            }
+            jobs->items.erase(remove_if(jobs->items.begin(), jobs->items.end(), 
+                                        [&removed](const JsonValue& job) {
+                                            return removed.count(job_id(job)) != 0;
+                                        }), 
+                              jobs->items.end());
+        }
+    }
+    if (const JsonValue* changed = delta.find("job")) {
+        unordered_map<string, size_t> positions;
+        for (size_t i = 0; i < jobs->items.size(); i++) {
+            positions[job_id(jobs->items[i])] = i;
+        }
+        for (const JsonValue& job : changed->items) {
+            unordered_map<string, size_t>::iterator position = positions.find(job_id(job));
+            if (position != positions.end()) {
+                jobs->items[position->second] = job;
+            } else {
+                positions[job_id(job)] = jobs->items.size();
+                jobs->items.push_back(job);
+            }
+        }
+    }
+    display = move(full);
+}
+
+/**
+ * Rebuilds the full JSON of a display file written with --delta-display, and
+ * prints it to stdout. Usage: display_reader <display file>
+ *
+ * A delta file names the time of the display it is based on, whose file
+ * (<input>_D<time>.json, next to the given file) is read in turn, back to a full
+ * display; a full display file is printed as it is. See DisplayWriter in
+ * DisplaySnapshot.h for the delta format.
+ *
+ * @param argc The number of command line arguments.
+ * @param argv An array of command line arguments.
+ * @return Returns 0 upon success.
+ * @throws runtime_error If the file is missing, a file it is based on cannot be
+ * read, or a file is malformed.
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        throw runtime_error("Error: Please specify a display file.");
+    }
+    string filename(argv[1]);
+    string::size_type suffix = filename.rfind("_D");
+    if (suffix == string::npos) {
+        throw runtime_error("Error: A display file is named <input>_D<time>.json.");
+    }
+    string prefix = filename.substr(0, suffix);
+    
+    // Read back to a full display, then apply the deltas in order
+    vector<JsonValue> deltas;
+    unordered_set<string> visited;
+    JsonValue display = read_display(filename);
+    visited.insert(filename);
+    while (const JsonValue* base_time = display.find("base_time")) {
+        string base_filename = prefix + "_D" + base_time->text + ".json";
+        if (!visited.insert(base_filename).second) {
+            throw runtime_error("Error: Display file " + base_filename
+                                + " is based on itself.");
+        }
+        deltas.push_back(move(display));
+        display = read_display(base_filename);
+    }
+    for (vector<JsonValue>::reverse_iterator delta = deltas.rbegin();
+         delta != deltas.rend(); ++delta) {
+        apply_delta(display, *delta);
+    }
+    
+    write_json(cout, display);
+    cout << endl;
+    return 0;
+}
@@ -0,0 +1,627 @@
+#include <algorithm>
+#include <numeric>
+#include <charconv>
+#include <fstream>
+#include <string_view>
+#include <unordered_set>
+
+#include "DisplaySnapshot.h"
+
+using namespace std;
+
+// Table components
+const string_view LEFT_COLUMN_BORDER = "| ";
+const string_view CENTER_COLUMN_BORDER = " | ";
+const string_view RIGHT_COLUMN_BORDER = " |";
+const char TITLE_PADDING = '=';
+const string_view TITLE_BORDER = "===";
+const char HORIZONTAL_BORDER = '-';
+const char PADDING = ' ';
+
+const string_view JOB_HEADERS[] = {
+    "#",
+    "State",
+    "Time Remaining",
+    "Turnaround Time (Unweighted)",
+    "Turnaround Time (Weighted)"
+};
+const string_view QUEUE_HEADERS[] = {
+    "Jobs"
+};
+const string_view LATENCY_HEADERS[] = {
+    "Latency",
+    "Count",
+    "p50",
+    "p90",
+    "p99",
+    "p99.9",
+    "Max"
+};
+// Indexed by DisplaySnapshot::Latency
+const string_view LATENCY_NAMES[] = {
+    "Hold queue 1",
+    "Hold queue 2",
+    "Ready queue",
+    "Device wait queue",
+    "Response",
+    "Turnaround"
+};
+const string_view LATENCY_JSON_NAMES[] = {
+    "holdq1",
+    "holdq2",
+    "readyq",
+    "waitq",
+    "response",
+    "turnaround"
+};
+const string_view LATENCY_JSON_PERCENTILES[] = {
+    "p50",
+    "p90",
+    "p99",
+    "p999"
+};
+const string_view RETIRED_HEADERS[] = {
+    "Count",
+    "Total Turnaround Time (Unweighted)",
+    "Total Turnaround Time (Weighted)",
+    "Max Turnaround Time (Unweighted)"
+};
+
+size_t table_width(const size_t* column_widths, int columns) {
+    return accumulate(column_widths, column_widths + columns, (size_t) 0)
+           + LEFT_COLUMN_BORDER.size() 
+           + RIGHT_COLUMN_BORDER.size()
+           + CENTER_COLUMN_BORDER.size() * (columns - 1);
+}
+
+void write_rule(OutputBuffer& out, size_t width) {
+    out.append_repeated(HORIZONTAL_BORDER, width).append('\n');
+}
+
+void write_cell(OutputBuffer& out, int column, string_view contents, size_t width) {
+    out.append((column == 0) ? LEFT_COLUMN_BORDER : CENTER_COLUMN_BORDER)
+       .append(contents)
+       .append_repeated(PADDING, (long) width - (long) contents.size());
+}
+
+void end_row(OutputBuffer& out) {
+    out.append(RIGHT_COLUMN_BORDER).append('\n');
+}
+
+/**
+ * Writes the title, header row and borders above the rows of a table. The title 
+ * is centered in the width of the table.
+ */
+void write_table_head(OutputBuffer& out, string_view title, const string_view* headers, 
+                      const size_t* column_widths, int columns) {
+    size_t width = table_width(column_widths, columns);
+    size_t title_size = 2 * TITLE_BORDER.size() + 2 + title.size();
+    long title_padding = (long) width - (long) title_size;
+    long left_title_padding = (title_padding > 0) ? title_padding / 2 : 0;
+    out.append_repeated(TITLE_PADDING, left_title_padding)
+       .append(TITLE_BORDER).append(PADDING).append(title).append(PADDING).append(TITLE_BORDER)
+       .append_repeated(TITLE_PADDING, title_padding - left_title_padding)
+       .append('\n');
+    write_rule(out, width);
+    for (int i = 0; i < columns; i++) {
+        write_cell(out, i, headers[i], column_widths[i]);
+    }
+    end_row(out);
+    write_rule(out, width);
+}
+
+/**
+ * Writes a table of the job numbers in a queue, in queue order. Column widths are 
+ * measured in a first pass over the queue, so the numbers are formatted twice 
+ * rather than stored.
+ */
+void write_queue_table(OutputBuffer& out, string_view queue_name, const vector<int>& queue) {
+    OutputBuffer::NumberBuffer buffer;
+    size_t column_widths[] = { QUEUE_HEADERS[0].size() };
+    for (int number : queue) {
+        column_widths[0] = max(column_widths[0], OutputBuffer::format_int(buffer, number).size());
+    }
+    write_table_head(out, queue_name, QUEUE_HEADERS, column_widths, 1);
+    for (int number : queue) {
+        write_cell(out, 0, OutputBuffer::format_int(buffer, number), column_widths[0]);
+        end_row(out);
+    }
+    write_rule(out, table_width(column_widths, 1));
+}
+
+/**
+ * Gets the state of a job shown in the jobs table.
+ * @param buffer Holds the state if it is not a constant string.
+ */
+string_view get_job_state(const DisplaySnapshot::JobEntry& job, 
+                          OutputBuffer::NumberBuffer& buffer) {
+    switch (job.location) {
+        case DisplaySnapshot::Location::Cpu: return "CPU";
+        case DisplaySnapshot::Location::Hold1: return "Hold queue 1";
+        case DisplaySnapshot::Location::Hold2: return "Hold queue 2";
+        case DisplaySnapshot::Location::LongQ: return "Long queue";
+        case DisplaySnapshot::Location::Ready: return "Ready queue";
+        case DisplaySnapshot::Location::Wait: return "Device wait queue";
+        case DisplaySnapshot::Location::Complete: {
+            const string_view COMPLETE = "Complete at time ";
+            COMPLETE.copy(buffer, COMPLETE.size());
+            to_chars_result result = to_chars(buffer + COMPLETE.size(), 
+                                              buffer + OutputBuffer::NUMBER_BUFFER_SIZE, 
+                                              job.completion_time);
+            return string_view(buffer, result.ptr - buffer);
+        }
+        default: return "???";
+    }
+}
+
+int unweighted_turnaround(const DisplaySnapshot::JobEntry& job) {
+    return job.completion_time - job.arrival_time;
+}
+
+double weighted_turnaround(const DisplaySnapshot::JobEntry& job) {
+    return (job.completion_time - job.arrival_time) / (double) job.runtime;
+}
+
+// The formatted cells of a row of the jobs table
+struct JobRow {
+    OutputBuffer::NumberBuffer buffers[5];
+    string_view cells[5];
+};
+
+/**
+ * Formats the cells of a job's row in the jobs table. Times that do not apply 
+ * (no time remaining, or not complete yet) are left empty.
+ */
+void format_job_row(const DisplaySnapshot::JobEntry& job, JobRow& row) {
+    row.cells[0] = OutputBuffer::format_int(row.buffers[0], job.number);
+    row.cells[1] = get_job_state(job, row.buffers[1]);
+    row.cells[2] = (job.time_remaining == 0) ? string_view() 
+                   : OutputBuffer::format_int(row.buffers[2], job.time_remaining);
+    int unweighted = unweighted_turnaround(job);
+    row.cells[3] = (unweighted < 0) ? string_view() 
+                   : OutputBuffer::format_int(row.buffers[3], unweighted);
+    double weighted = weighted_turnaround(job);
+    row.cells[4] = (weighted < 0) ? string_view() 
+                   : OutputBuffer::format_fixed(row.buffers[4], weighted);
+}
+
+// The formatted cells of a row of the latency table
+struct LatencyRow {
+    OutputBuffer::NumberBuffer buffers[7];
+    string_view cells[7];
+};
+
+void format_latency_row(int latency, const DisplaySnapshot::LatencySummary& summary, 
+                        LatencyRow& row) {
+    row.cells[0] = LATENCY_NAMES[latency];
+    row.cells[1] = OutputBuffer::format_unsigned(row.buffers[1], summary.count);
+    for (int i = 0; i < DisplaySnapshot::LATENCY_PERCENTILE_COUNT; i++) {
+        row.cells[2 + i] = OutputBuffer::format_int(row.buffers[2 + i], summary.percentiles[i]);
+    }
+    row.cells[6] = OutputBuffer::format_int(row.buffers[6], summary.max);
+}
+
+/**
+ * Writes a table with a row of percentiles per latency.
+ */
+void write_latency_table(OutputBuffer& out, const DisplaySnapshot::LatencySummary* latencies) {
+    const int LATENCY_COLUMNS = 7;
+    LatencyRow row;
+    size_t column_widths[LATENCY_COLUMNS];
+    for (int i = 0; i < LATENCY_COLUMNS; i++) {
+        column_widths[i] = LATENCY_HEADERS[i].size();
+    }
+    for (int latency = 0; latency < DisplaySnapshot::LATENCIES; latency++) {
+        format_latency_row(latency, latencies[latency], row);
+        for (int i = 0; i < LATENCY_COLUMNS; i++) {
+            column_widths[i] = max(column_widths[i], row.cells[i].size());
+        }
+    }
+    write_table_head(out, "Latency Percentiles", LATENCY_HEADERS, column_widths, LATENCY_COLUMNS);
+    for (int latency = 0; latency < DisplaySnapshot::LATENCIES; latency++) {
+        format_latency_row(latency, latencies[latency], row);
+        for (int i = 0; i < LATENCY_COLUMNS; i++) {
+            write_cell(out, i, row.cells[i], column_widths[i]);
+        }
+        end_row(out);
+    }
+    write_rule(out, table_width(column_widths, LATENCY_COLUMNS));
+}
+
+/**
+ * Gets the average turnarounds of all completed jobs, including retired ones.
+ */
+void DisplaySnapshot::get_average_turnarounds(double& unweighted, double& weighted) const {
+    unweighted = turnarounds.mean();
+    weighted = weighted_turnarounds.mean();
+}
+
+void DisplaySnapshot::write_text(OutputBuffer& out) const {
+    // Print jobs
+    const int JOB_COLUMNS = 5;
+    JobRow row;
+    size_t column_widths[JOB_COLUMNS];
+    for (int i = 0; i < JOB_COLUMNS; i++) {
+        column_widths[i] = JOB_HEADERS[i].size();
+    }
+    for (const JobEntry& job : jobs) {
+        format_job_row(job, row);
+        for (int i = 0; i < JOB_COLUMNS; i++) {
+            column_widths[i] = max(column_widths[i], row.cells[i].size());
+        }
+    }
+    write_table_head(out, "Jobs", JOB_HEADERS, column_widths, JOB_COLUMNS);
+    for (const JobEntry& job : jobs) {
+        format_job_row(job, row);
+        for (int i = 0; i < JOB_COLUMNS; i++) {
+            write_cell(out, i, row.cells[i], column_widths[i]);
+        }
+        end_row(out);
+    }
+    write_rule(out, table_width(column_widths, JOB_COLUMNS));
+    
+    // Print queues
+    write_queue_table(out, "Hold Queue 1", hold_queue_1);
+    write_queue_table(out, "Hold Queue 2", hold_queue_2);
+    write_queue_table(out, "Long Queue", long_queue);
+    write_queue_table(out, "Ready Queue", ready_queue);
+    write_queue_table(out, "Device Wait Queue", wait_queue);
+    write_queue_table(out, "Complete Queue", complete_queue);
+    
+    if (streaming) {
+        const int RETIRED_COLUMNS = 4;
+        OutputBuffer::NumberBuffer buffers[RETIRED_COLUMNS];
+        string_view cells[RETIRED_COLUMNS] = {
+            OutputBuffer::format_unsigned(buffers[0], retired_jobs),
+            OutputBuffer::format_int(buffers[1], retired_turnaround_sum),
+            OutputBuffer::format_fixed(buffers[2], retired_weighted_turnaround_sum),
+            OutputBuffer::format_int(buffers[3], retired_max_turnaround)
+        };
+        size_t retired_widths[RETIRED_COLUMNS];
+        for (int i = 0; i < RETIRED_COLUMNS; i++) {
+            retired_widths[i] = max(RETIRED_HEADERS[i].size(), cells[i].size());
+        }
+        write_table_head(out, "Retired Jobs", RETIRED_HEADERS, retired_widths, RETIRED_COLUMNS);
+        for (int i = 0; i < RETIRED_COLUMNS; i++) {
+            write_cell(out, i, cells[i], retired_widths[i]);
+        }
+        end_row(out);
+        write_rule(out, table_width(retired_widths, RETIRED_COLUMNS));
+    }
+    
+    if (include_latencies) {
+        write_latency_table(out, latencies);
+    }
+    
+    if (include_system_turnaround) {
+        double average_unweighted_turnaround;
+        double average_weighted_turnaround;
+        get_average_turnarounds(average_unweighted_turnaround, average_weighted_turnaround);
+        out.append("System average unweighted turnaround: ")
+           .append_general(average_unweighted_turnaround).append('\n');
+        out.append("System average weighted turnaround: ")
+           .append_general(average_weighted_turnaround).append('\n');
+    }
+    if (include_turnaround_deviation) {
+        out.append("System unweighted turnaround standard deviation: ")
+           .append_general(turnarounds.standard_deviation()).append('\n');
+        out.append("System weighted turnaround standard deviation: ")
+           .append_general(weighted_turnarounds.standard_deviation()).append('\n');
+    }
+}
+
+/**
+ * Appends job numbers to a JSON array.
+ */
+void write_json_queue(OutputBuffer& out, const vector<int>& queue) {
+    out.append('[');
+    bool first = true;
+    for (int number : queue) {
+        if (!first) {
+            out.append(", ");
+        }
+        out.append_int(number);
+        first = false;
+    }
+    out.append(']');
+}
+
+/**
+ * Appends devices to the JSON output: a number with a single device class, as 
+ * in earlier versions, or an array with one number per class.
+ */
+void write_json_devices(OutputBuffer& out, const DeviceVector& devices, int device_classes) {
+    if (device_classes == 1) {
+        out.append_int(devices[0]);
+        return;
+    }
+    out.append('[');
+    for (int i = 0; i < device_classes; i++) {
+        out.append_int(devices[i]);
+        if (i != device_classes - 1) {
+            out.append(", ");
+        }
+    }
+    out.append(']');
+}
+
+void write_json_job(OutputBuffer& out, const DisplaySnapshot::JobEntry& job, 
+                    int device_classes) {
+    out.append("{")
+       .append("\"arrival_time\": ").append_int(job.arrival_time).append(", ");
+    if (job.devices_shown) {
+        out.append("\"devices_allocated\": ");
+        write_json_devices(out, job.allocated_devices, device_classes);
+        out.append(", ");
+    }
+    out.append("\"id\": ").append_int(job.number).append(", ")
+       .append("\"remaining_time\": ").append_int(job.time_remaining);
+    if (job.complete) {
+        out.append(", ")
+           .append("\"completion_time\": ").append_int(job.completion_time);
+    }
+    out.append("}");
+}
+
+void DisplaySnapshot::write_json(OutputBuffer& out) const {
+    const string_view DELIMITER = ", ";
+    
+    out.append("{")
+       .append("\"readyq\": ");
+    write_json_queue(out, ready_queue);
+    out.append(DELIMITER)
+       .append("\"current_time\": ").append_int(time).append(DELIMITER)
+       .append("\"total_memory\": ").append_int(total_memory).append(DELIMITER)
+       .append("\"available_memory\": ").append_int(available_memory).append(DELIMITER)
+       .append("\"total_devices\": ");
+    write_json_devices(out, total_devices, device_classes);
+    out.append(DELIMITER)
+       .append("\"running\" :").append_int(running).append(DELIMITER)
+       .append("\"submitq\": []").append(DELIMITER)
+       .append("\"longq\": ");
+    write_json_queue(out, long_queue);
+    out.append(DELIMITER)
+       .append("\"holdq2\": ");
+    write_json_queue(out, hold_queue_2);
+    out.append(DELIMITER)
+       .append("\"job\": [");
+    bool first = true;
+    for (const JobEntry& job : jobs) {
+        if (!first) {
+            out.append(DELIMITER);
+        }
+        write_json_job(out, job, device_classes);
+        first = false;
+    }
+    out.append("]").append(DELIMITER)
+       .append("\"holdq1\": ");
+    write_json_queue(out, hold_queue_1);
+    out.append(DELIMITER)
+       .append("\"available_devices\": ");
+    write_json_devices(out, available_devices, device_classes);
+    out.append(DELIMITER)
+       .append("\"quantum\": ").append_int(quantum).append(DELIMITER)
+       .append("\"completeq\": ");
+    write_json_queue(out, complete_queue);
+    out.append(DELIMITER)
+       .append("\"waitq\": ");
+    write_json_queue(out, wait_queue);
+    write_json_totals(out);
+    out.append("}");
+}
+
+/**
+ * Appends the totals of the retired jobs, the latency percentiles and the system 
+ * averages and standard deviations, if they are shown, as members that follow 
+ * the queues.
+ */
+void DisplaySnapshot::write_json_totals(OutputBuffer& out) const {
+    const string_view DELIMITER = ", ";
+    if (streaming) {
+        out.append(DELIMITER)
+           .append("\"retired\": {")
+           .append("\"count\": ").append_unsigned(retired_jobs).append(DELIMITER)
+           .append("\"turnaround_sum\": ").append_int(retired_turnaround_sum).append(DELIMITER)
+           .append("\"weighted_turnaround_sum\": ")
+           .append_general(retired_weighted_turnaround_sum).append(DELIMITER)
+           .append("\"max_turnaround\": ").append_int(retired_max_turnaround)
+           .append("}");
+    }
+    
+    if (include_latencies) {
+        out.append(DELIMITER).append("\"latency\": {");
+        for (int latency = 0; latency < LATENCIES; latency++) {
+            const LatencySummary& summary = latencies[latency];
+            if (latency != 0) {
+                out.append(DELIMITER);
+            }
+            out.append("\"").append(LATENCY_JSON_NAMES[latency]).append("\": {")
+               .append("\"count\": ").append_unsigned(summary.count);
+            for (int i = 0; i < LATENCY_PERCENTILE_COUNT; i++) {
+                out.append(DELIMITER).append("\"").append(LATENCY_JSON_PERCENTILES[i])
+                   .append("\": ").append_int(summary.percentiles[i]);
+            }
+            out.append(DELIMITER).append("\"max\": ").append_int(summary.max).append("}");
+        }
+        out.append("}");
+    }
+    
+    if (include_system_turnaround) {
+        double average_unweighted_turnaround;
+        double average_weighted_turnaround;
+        get_average_turnarounds(average_unweighted_turnaround, average_weighted_turnaround);
+        out.append(DELIMITER)
+           .append("\"turnaround\": ").append_general(average_unweighted_turnaround)
+           .append(DELIMITER)
+           .append("\"weighted_turnaround\": ").append_general(average_weighted_turnaround);
+    }
+    if (include_turnaround_deviation) {
+        out.append(DELIMITER)
+           .append("\"turnaround_stddev\": ").append_general(turnarounds.standard_deviation())
+           .append(DELIMITER)
+           .append("\"weighted_turnaround_stddev\": ")
+           .append_general(weighted_turnarounds.standard_deviation());
+    }
+}
+
+/**
+ * Checks if a job has the same members in the JSON output of two displays.
+ */
+bool same_json_job(const DisplaySnapshot::JobEntry& a, const DisplaySnapshot::JobEntry& b) {
+    return a.number == b.number
+           && a.arrival_time == b.arrival_time
+           && a.time_remaining == b.time_remaining
+           && a.devices_shown == b.devices_shown
+           && (!a.devices_shown || a.allocated_devices == b.allocated_devices)
+           && a.complete == b.complete
+           && (!a.complete || a.completion_time == b.completion_time);
+}
+
+/**
+ * Appends the change of a queue between two displays. If the current queue 
+ * continues what is left of the previous one after jobs left its front, this is 
+ * {"drop": <jobs that left>, "append": [<jobs that joined>]}, and otherwise the 
+ * whole current queue.
+ */
+void write_json_queue_edit(OutputBuffer& out, const vector<int>& previous, 
+                           const vector<int>& current) {
+    // The fewest dropped jobs are tried first; keeping no jobs is a full array
+    for (size_t drop = 0; drop < previous.size(); drop++) {
+        size_t kept = previous.size() - drop;
+        if (kept <= current.size() 
+            && equal(previous.begin() + drop, previous.end(), current.begin())) {
+            out.append("{\"drop\": ").append_unsigned(drop).append(", \"append\": [");
+            for (size_t i = kept; i < current.size(); i++) {
+                if (i != kept) {
+                    out.append(", ");
+                }
+                out.append_int(current[i]);
+            }
+            out.append("]}");
+            return;
+        }
+    }
+    write_json_queue(out, current);
+}
+
+DisplayWriter::DisplayWriter(bool delta) 
+: m_delta(delta), m_has_previous(false), m_previous(), m_previous_jobs(), m_buffer(), 
+  m_full_files(0), m_delta_files(0), m_json_bytes(0) {
+}
+
+/**
+ * Appends the delta of a display from the previous one (see DisplayWriter). 
+ * Members are in the same order as in a full display.
+ */
+void DisplayWriter::write_json_delta(const DisplaySnapshot& snapshot, OutputBuffer& out) const {
+    const string_view DELIMITER = ", ";
+    
+    out.append("{")
+       .append("\"base_time\": ").append_int(m_previous.time).append(DELIMITER)
+       .append("\"readyq\": ");
+    write_json_queue_edit(out, m_previous.ready_queue, snapshot.ready_queue);
+    out.append(DELIMITER)
+       .append("\"current_time\": ").append_int(snapshot.time).append(DELIMITER)
+       .append("\"total_memory\": ").append_int(snapshot.total_memory).append(DELIMITER)
+       .append("\"available_memory\": ").append_int(snapshot.available_memory)
+       .append(DELIMITER)
+       .append("\"total_devices\": ");
+    write_json_devices(out, snapshot.total_devices, snapshot.device_classes);
+    out.append(DELIMITER)
+       .append("\"running\" :").append_int(snapshot.running).append(DELIMITER)
+       .append("\"longq\": ");
+    write_json_queue_edit(out, m_previous.long_queue, snapshot.long_queue);
+    out.append(DELIMITER)
+       .append("\"holdq2\": ");
+    write_json_queue_edit(out, m_previous.hold_queue_2, snapshot.hold_queue_2);
+    out.append(DELIMITER)
+       .append("\"job\": [");
+    bool first = true;
+    size_t jobs_kept = 0;
+    for (const DisplaySnapshot::JobEntry& job : snapshot.jobs) {
+        unordered_map<int, size_t>::const_iterator previous = m_previous_jobs.find(job.number);
+        if (previous != m_previous_jobs.end()) {
+            jobs_kept++;
+            if (same_json_job(job, m_previous.jobs[previous->second])) {
+                continue;
+            }
+        }
+        if (!first) {
+            out.append(DELIMITER);
+        }
+        write_json_job(out, job, snapshot.device_classes);
+        first = false;
+    }
+    out.append("]").append(DELIMITER)
+       .append("\"removed_jobs\": [");
+    if (jobs_kept != m_previous.jobs.size()) {
+        // Jobs only leave the job table in streaming mode, so this is rare
+        unordered_set<int> current_jobs;
+        for (const DisplaySnapshot::JobEntry& job : snapshot.jobs) {
+            current_jobs.insert(job.number);
+        }
+        first = true;
+        for (const DisplaySnapshot::JobEntry& job : m_previous.jobs) {
+            if (current_jobs.count(job.number) == 0) {
+                if (!first) {
+                    out.append(DELIMITER);
+                }
+                out.append_int(job.number);
+                first = false;
+            }
+        }
+    }
+    out.append("]").append(DELIMITER)
+       .append("\"holdq1\": ");
+    write_json_queue_edit(out, m_previous.hold_queue_1, snapshot.hold_queue_1);
+    out.append(DELIMITER)
+       .append("\"available_devices\": ");
+    write_json_devices(out, snapshot.available_devices, snapshot.device_classes);
+    out.append(DELIMITER)
+       .append("\"quantum\": ").append_int(snapshot.quantum).append(DELIMITER)
+       .append("\"completeq\": ");
+    write_json_queue_edit(out, m_previous.complete_queue, snapshot.complete_queue);
+    out.append(DELIMITER)
+       .append("\"waitq\": ");
+    write_json_queue_edit(out, m_previous.wait_queue, snapshot.wait_queue);
+    snapshot.write_json_totals(out);
+    out.append("}");
+}
+
+void DisplayWriter::write(const DisplaySnapshot& snapshot, ostream& console, 
+                          const string& filename) {
+    m_buffer.clear();
+    snapshot.write_text(m_buffer);
+    console.write(m_buffer.data(), m_buffer.size()) << endl;
+    
+    m_buffer.clear();
+    if (m_delta && m_has_previous && m_previous.time != snapshot.time 
+        && m_previous.device_classes == snapshot.device_classes) {
+        write_json_delta(snapshot, m_buffer);
+        m_delta_files++;
+    } else {
+        snapshot.write_json(m_buffer);
+        m_full_files++;
+    }
+    ofstream out_file;
+    out_file.open(filename);
+    out_file.write(m_buffer.data(), m_buffer.size());
+    out_file.close();
+    m_json_bytes += m_buffer.size();
+    
+    if (m_delta) {
+        // Copying reuses the storage of the previous snapshot
+        m_previous = snapshot;
+        m_has_previous = true;
+        m_previous_jobs.clear();
+        for (size_t i = 0; i < m_previous.jobs.size(); i++) {
+            m_previous_jobs[m_previous.jobs[i].number] = i;
+        }
+    }
+}
+
+void DisplayWriter::print_stats(ostream& out) const {
+    out << "display_files_full: " << m_full_files << endl;
+    out << "display_files_delta: " << m_delta_files << endl;
+    out << "display_json_bytes: " << m_json_bytes << endl;
+}
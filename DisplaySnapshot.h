@@ -0,0 +1,167 @@
+#ifndef _DISPLAY_SNAPSHOT_H_
+#define _DISPLAY_SNAPSHOT_H_
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <unordered_map>
+#include <cstddef>
+
+#include "DeviceVector.h"
+#include "OutputBuffer.h"
+#include "RunningStats.h"
+
+/**
+ * @struct DisplaySnapshot
+ * @brief A copy of the parts of the system state shown by a display.
+ *
+ * A display copies what it shows into a snapshot (see
+ * SystemState::capture_display()), and the text and JSON output are rendered from
+ * the snapshot alone, so they can be rendered on another thread while the
+ * simulation goes on. Jobs are identified by their numbers, and appear in the
+ * order of the job table.
+ */
+struct DisplaySnapshot {
+    /** Where a job is shown in the jobs table; a job on the CPU is shown there. */
+    enum class Location : unsigned char {
+        Cpu,
+        Hold1,
+        Hold2,
+        LongQ,
+        Ready,
+        Wait,
+        Complete,
+        Unknown,
+    };
+    
+    /** The durations whose percentiles are shown, in the order they are listed. */
+    enum class Latency : unsigned char {
+        Hold1,      /**< Time spent in hold queue 1. */
+        Hold2,      /**< Time spent in hold queue 2. */
+        Ready,      /**< Time spent in the ready queue. */
+        Wait,       /**< Time spent in the device wait queue. */
+        Response,   /**< Time from arrival to first being put on the CPU. */
+        Turnaround, /**< Time from arrival to completion. */
+    };
+    static constexpr int LATENCIES = 6;
+    
+    /** The percentiles shown, in thousandths. */
+    static constexpr int LATENCY_PERCENTILES[] = { 500, 900, 990, 999 };
+    static constexpr int LATENCY_PERCENTILE_COUNT = 4;
+    
+    struct LatencySummary {
+        unsigned long count;
+        int percentiles[LATENCY_PERCENTILE_COUNT];
+        int max;
+    };
+    
+    struct JobEntry {
+        int number;
+        int arrival_time;
+        int completion_time;
+        int runtime;
+        int time_remaining;
+        Location location;
+        bool devices_shown; /**< Whether the job is in the ready or wait queue or on the CPU. */
+        bool complete;      /**< Whether the job is in the complete queue. */
+        DeviceVector allocated_devices;
+    };
+    
+    int time = 0;
+    int total_memory = 0;
+    int available_memory = 0;
+    DeviceVector total_devices;
+    DeviceVector available_devices;
+    int device_classes = 1;
+    int quantum = 0;
+    int running = 0;
+    bool include_system_turnaround = false;
+    bool include_turnaround_deviation = false;
+    
+    // Turnarounds of all completed jobs, including retired ones
+    RunningStats turnarounds;
+    RunningStats weighted_turnarounds;
+    
+    // Percentiles of the time jobs spend in each state, only shown if included
+    bool include_latencies = false;
+    LatencySummary latencies[LATENCIES] = {};
+    
+    // Totals of retired jobs, only shown in streaming mode
+    bool streaming = false;
+    unsigned long retired_jobs = 0;
+    long retired_turnaround_sum = 0;
+    double retired_weighted_turnaround_sum = 0;
+    int retired_max_turnaround = 0;
+    
+    std::vector<JobEntry> jobs;
+    
+    // The job numbers in each queue, in queue order
+    std::vector<int> hold_queue_1;
+    std::vector<int> hold_queue_2;
+    std::vector<int> long_queue;
+    std::vector<int> ready_queue;
+    std::vector<int> wait_queue;
+    std::vector<int> complete_queue;
+    
+    /**
+     * @brief Appends the text display: the jobs table, a table per queue, and the
+     * retired jobs, latency percentiles and system averages (and standard 
+     * deviations) if they are included.
+     */
+    void write_text(OutputBuffer& out) const;
+    
+    /** @brief Appends the JSON display, which has the same contents as the text. */
+    void write_json(OutputBuffer& out) const;
+    
+    /** @brief Appends the members of the JSON display that follow the queues. */
+    void write_json_totals(OutputBuffer& out) const;
+    
+    void get_average_turnarounds(double& unweighted, double& weighted) const;
+};
+
+/**
+ * @class DisplayWriter
+ * @brief Writes displays to the console and to JSON files.
+ *
+ * In delta mode, a JSON file only holds what changed since the previous display
+ * written by the same DisplayWriter: a "base_time" member names the previous
+ * display's file, "job" lists the jobs that are new or whose members changed,
+ * "removed_jobs" the numbers of the jobs no longer listed, and each queue is
+ * either a full array or {"drop": k, "append": [...]}, meaning that k jobs left
+ * the front of the queue and the listed jobs joined its back. The other members
+ * are written in full. The first display is always written in full, as is one at
+ * the same time as the previous display (whose file it replaces).
+ * display_reader rebuilds the full JSON of a delta file.
+ */
+class DisplayWriter {
+public:
+    /** @param delta Whether to write JSON files as deltas of the previous display. */
+    explicit DisplayWriter(bool delta);
+    
+    /**
+     * @brief Writes the text display to the console and the JSON display to a file.
+     * @param snapshot The display.
+     * @param console The stream to write the text display to.
+     * @param filename The name of the JSON file.
+     */
+    void write(const DisplaySnapshot& snapshot, std::ostream& console,
+               const std::string& filename);
+    
+    void print_stats(std::ostream& out) const;
+
+private:
+    bool m_delta;
+    bool m_has_previous;
+    DisplaySnapshot m_previous;
+    /** The index in m_previous.jobs of each job number. */
+    std::unordered_map<int, std::size_t> m_previous_jobs;
+    OutputBuffer m_buffer;
+    
+    unsigned long m_full_files;
+    unsigned long m_delta_files;
+    unsigned long long m_json_bytes;
+    
+    void write_json_delta(const DisplaySnapshot& snapshot, OutputBuffer& out) const;
+};
+
+#endif // _DISPLAY_SNAPSHOT_H_
@@ -23,6 +23,21 @@ public:
         External,
     };
     
+    /**
+     * @enum Kind
+     * @brief Identifies the concrete class of an event.
+     * 
+     * The set of event classes is closed, so code that needs the concrete class 
+     * (such as returning an event to its pool) can switch on the kind instead of 
+     * using dynamic_cast.
+     */
+    enum class Kind {
+        JobArrival,
+        DeviceRequest,
+        DeviceRelease,
+        Display,
+    };
+    
     /**
      * @brief Constructs an Event object with the specified time.
      * 
@@ -61,6 +76,15 @@ public:
      */
     virtual Type get_type() const = 0;
     
+    /**
+     * @brief Gets the kind of the event.
+     * 
+     * This pure virtual function must be implemented by derived classes to return their kind.
+     * 
+     * @return The kind of the event.
+     */
+    virtual Kind get_kind() const = 0;
+    
     /**
      * @brief Compares two events based on their time.
      * 
@@ -0,0 +1,45 @@
+#include <stdexcept>
+#include <string>
+
+#include "EventPool.h"
+
+using namespace std;
+
+EventPool::EventPool() 
+: m_job_arrival_events(), m_device_request_events(), 
+  m_device_release_events(), m_display_events() {
+}
+
+void EventPool::release(Event* e) {
+    switch (e->get_kind()) {
+        case Event::Kind::JobArrival: 
+            m_job_arrival_events.release(static_cast<JobArrivalEvent*>(e));
+            break;
+        case Event::Kind::DeviceRequest: 
+            m_device_request_events.release(static_cast<DeviceRequestEvent*>(e));
+            break;
+        case Event::Kind::DeviceRelease: 
+            m_device_release_events.release(static_cast<DeviceReleaseEvent*>(e));
+            break;
+        case Event::Kind::Display: 
+            m_display_events.release(static_cast<DisplayEvent*>(e));
+            break;
+        default: throw runtime_error("Error: Invalid event kind.");
+    }
+}
+
+/**
+ * @brief Prints one line per pool in the form "event_pool.<class>: high_water=<n> capacity=<n>".
+ */
+template <typename T>
+void print_pool_stats(ostream& out, const string& name, const ObjectPool<T>& pool) {
+    out << "event_pool." << name << ": high_water=" << pool.high_water() 
+        << " capacity=" << pool.capacity() << endl;
+}
+
+void EventPool::print_stats(ostream& out) const {
+    print_pool_stats(out, "job_arrival", m_job_arrival_events);
+    print_pool_stats(out, "device_request", m_device_request_events);
+    print_pool_stats(out, "device_release", m_device_release_events);
+    print_pool_stats(out, "display", m_display_events);
+}
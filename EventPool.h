@@ -0,0 +1,71 @@
+#ifndef _EVENT_POOL_H_
+#define _EVENT_POOL_H_
+
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "ObjectPool.h"
+#include "Event.h"
+#include "JobArrivalEvent.h"
+#include "DeviceRequestEvent.h"
+#include "DeviceReleaseEvent.h"
+#include "DisplayEvent.h"
+
+/**
+ * @class EventPool
+ * @brief Owns one ObjectPool per event class and recycles events through them.
+ * 
+ * Events are created with make() and must be returned with release() once they 
+ * have been processed, instead of being deleted.
+ */
+class EventPool {
+public:
+    EventPool();
+    
+    /**
+     * @brief Constructs an event in its class's pool.
+     * @tparam T The event class to construct.
+     * @param args The arguments forwarded to the constructor of T.
+     * @return The constructed event.
+     */
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        return pool<T>().acquire(std::forward<Args>(args)...);
+    }
+    
+    /**
+     * @brief Destructs an event and returns it to its class's pool.
+     * @param e An event previously returned by make().
+     */
+    void release(Event* e);
+    
+    /**
+     * @brief Prints the high-water mark and capacity of each pool.
+     * @param out The stream to print to.
+     */
+    void print_stats(std::ostream& out) const;
+    
+private:
+    template <typename T>
+    ObjectPool<T>& pool() {
+        if constexpr (std::is_same<T, JobArrivalEvent>::value) {
+            return m_job_arrival_events;
+        } else if constexpr (std::is_same<T, DeviceRequestEvent>::value) {
+            return m_device_request_events;
+        } else if constexpr (std::is_same<T, DeviceReleaseEvent>::value) {
+            return m_device_release_events;
+        } else {
+            static_assert(std::is_same<T, DisplayEvent>::value, 
+                          "EventPool does not hold this event class");
+            return m_display_events;
+        }
+    }
+    
+    ObjectPool<JobArrivalEvent> m_job_arrival_events;
+    ObjectPool<DeviceRequestEvent> m_device_request_events;
+    ObjectPool<DeviceReleaseEvent> m_device_release_events;
+    ObjectPool<DisplayEvent> m_display_events;
+};
+
+#endif // _EVENT_POOL_H_
@@ -0,0 +1,13 @@
+#include "EventQueue.h"
+
+using namespace std;
+
+bool event_later(const EventKey& a, const EventKey& b, TieOrder tie_order) {
+    if (a.time != b.time) {
+        return a.time > b.time;
+    } else if (tie_order == TieOrder::Fifo) {
+        return a.sequence > b.sequence;
+    } else {
+        return a.sequence < b.sequence;
+    }
+}
@@ -0,0 +1,158 @@
+#ifndef _EVENT_QUEUE_H_
+#define _EVENT_QUEUE_H_
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include "Event.h"
+
+/**
+ * @enum TieOrder
+ * @brief The order in which equal-time events are popped.
+ */
+enum class TieOrder {
+    Fifo,
+    Lifo,
+};
+
+/**
+ * @struct EventKey
+ * @brief The ordering key of a queued event.
+ */
+struct EventKey {
+    int time; /**< The time at which the event occurs. */
+    unsigned long sequence; /**< The number of events queued before this one. */
+};
+
+/**
+ * @brief Checks if the event with key a should be popped after the event with key b.
+ * 
+ * @param a The first key.
+ * @param b The second key.
+ * @param tie_order The order of equal-time events.
+ * @return True if a comes after b, false otherwise.
+ */
+bool event_later(const EventKey& a, const EventKey& b, TieOrder tie_order);
+
+/**
+ * @class EventQueue
+ * @brief A priority queue of pending events, ordered by time.
+ * 
+ * The queue is a binary heap keyed on (time, insertion sequence), so both push 
+ * and pop are O(log n). Events with equal times come out in insertion order 
+ * (TieOrder::Fifo), or in reverse insertion order (TieOrder::Lifo).
+ * 
+ * Only input commands are queued here; quantum ends are timers of the system's 
+ * TimingWheel, which fire before events at the same time. TieOrder::Lifo 
+ * reproduces the order of the original sorted-deque implementation, which 
+ * inserted each new event in front of any equal-time events of the same type.
+ * 
+ * @tparam T The stored event; either an Event pointer or an EventRecord held by 
+ *           value. T must provide get_time(), directly or through a pointer.
+ */
+template <typename T>
+class EventQueue {
+public:
+    /**
+     * @brief Constructs an empty EventQueue.
+     * @param tie_order The order in which equal-time events are popped.
+     */
+    explicit EventQueue(TieOrder tie_order = TieOrder::Fifo)
+    : m_heap(), m_later({ tie_order }), m_next_sequence(0) {
+    }
+    
+    /**
+     * @brief Adds an event to the queue. Pointers are stored, not owned.
+     * @param e The event to add.
+     */
+    void push(const T& e) {
+        m_heap.push_back({ { time_of(e), m_next_sequence++ }, e });
+        std::push_heap(m_heap.begin(), m_heap.end(), m_later);
+    }
+    
+    /**
+     * @brief Checks if the queue is empty.
+     * @return True if there are no pending events, false otherwise.
+     */
+    bool empty() const {
+        return m_heap.empty();
+    }
+    
+    /**
+     * @brief Gets the number of pending events.
+     * @return The number of pending events.
+     */
+    std::size_t size() const {
+        return m_heap.size();
+    }
+    
+    /**
+     * @brief Gets the next event without removing it from the queue.
+     * @return The next event.
+     */
+    const T& top() const {
+        return m_heap.front().event;
+    }
+    
+    /**
+     * @brief Removes the next event from the queue.
+     * @return The removed event.
+     */
+    T pop() {
+        std::pop_heap(m_heap.begin(), m_heap.end(), m_later);
+        T e = m_heap.back().event;
+        m_heap.pop_back();
+        return e;
+    }
+    
+    /**
+     * @brief Gets all pending events in the order they will be popped.
+     * 
+     * This copies and sorts the heap, so it is meant for debugging output only.
+     * 
+     * @return The pending events in pop order.
+     */
+    std::vector<T> sorted() const {
+        std::vector<Entry> entries(m_heap);
+        std::sort(entries.begin(), entries.end(), 
+                  [this](const Entry& a, const Entry& b) { return m_later(b, a); });
+        std::vector<T> events;
+        for (const Entry& entry : entries) {
+            events.push_back(entry.event);
+        }
+        return events;
+    }
+    
+private:
+    struct Entry {
+        EventKey key;
+        T event;
+    };
+    
+    /**
+     * @brief Heap comparator; std::push_heap builds a max-heap, so this returns 
+     * true if a should be popped after b.
+     */
+    struct Later {
+        TieOrder tie_order;
+        bool operator() (const Entry& a, const Entry& b) const {
+            return event_later(a.key, b.key, tie_order);
+        }
+    };
+    
+    static int time_of(const T& e) {
+        if constexpr (std::is_pointer<T>::value) {
+            return e->get_time();
+        } else {
+            return e.get_time();
+        }
+    }
+    
+    std::vector<Entry> m_heap;
+    Later m_later;
+    unsigned long m_next_sequence;
+};
+
+#endif // _EVENT_QUEUE_H_
@@ -0,0 +1,68 @@
+#include <stdexcept>
+
+#include "EventRecord.h"
+#include "JobArrivalEvent.h"
+#include "DeviceRequestEvent.h"
+#include "DeviceReleaseEvent.h"
+#include "DisplayEvent.h"
+#include "SystemState.h"
+
+using namespace std;
+
+EventRecord::EventRecord(int time, const Body& body) 
+: m_time(time), m_body(body) {
+}
+
+/**
+ * Process the record by switching on its kind and calling the matching handler.
+ * std::get_if on the known alternative compiles to a tag check, with no virtual call.
+ * @param state The current system state.
+ */
+void EventRecord::process(SystemState& state) const {
+    switch (get_kind()) {
+        case Event::Kind::JobArrival: {
+            const JobArrivalRecord* r = get_if<JobArrivalRecord>(&m_body);
+            DeviceVector max_devices = state.get_record_devices().take(r->max_devices);
+            JobArrivalEvent::handle(state, m_time, Job(m_time, r->job_number, r->max_memory, 
+                                                       max_devices, r->runtime, r->priority));
+            break;
+        }
+        case Event::Kind::DeviceRequest: {
+            const DeviceRequestRecord* r = get_if<DeviceRequestRecord>(&m_body);
+            DeviceRequestEvent::handle(state, m_time, r->job_number, 
+                                       state.get_record_devices().take(r->requested_devices));
+            break;
+        }
+        case Event::Kind::DeviceRelease: {
+            const DeviceReleaseRecord* r = get_if<DeviceReleaseRecord>(&m_body);
+            DeviceReleaseEvent::handle(state, m_time, r->job_number, 
+                                       state.get_record_devices().take(r->released_devices));
+            break;
+        }
+        case Event::Kind::Display: {
+            const DisplayRecord* r = get_if<DisplayRecord>(&m_body);
+            DisplayEvent::handle(state, m_time, *r->filename);
+            break;
+        }
+        default: throw runtime_error("Error: Invalid event kind.");
+    }
+}
+
+int EventRecord::get_time() const {
+    return m_time;
+}
+
+Event::Type EventRecord::get_type() const {
+    return Event::Type::External;
+}
+
+Event::Kind EventRecord::get_kind() const {
+    // The kinds of the alternatives of Body, in order
+    static const Event::Kind KINDS[] = {
+        Event::Kind::JobArrival,
+        Event::Kind::DeviceRequest,
+        Event::Kind::DeviceRelease,
+        Event::Kind::Display,
+    };
+    return KINDS[m_body.index()];
+}
@@ -0,0 +1,139 @@
+#ifndef _EVENT_RECORD_H_
+#define _EVENT_RECORD_H_
+
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "Event.h"
+#include "Job.h"
+#include "DeviceVector.h"
+
+class SystemState;
+
+/**
+ * @class RecordDeviceTable
+ * @brief The device vectors of pending EventRecords, which refer to them by index.
+ * 
+ * A DeviceVector has a count for every possible device class, so records keep 
+ * theirs here rather than inline. Slots are reused once their record has been 
+ * processed.
+ */
+class RecordDeviceTable {
+public:
+    /**
+     * @brief Stores a device vector.
+     * @param devices The device vector.
+     * @return The index of the device vector.
+     */
+    int store(const DeviceVector& devices) {
+        if (m_free.empty()) {
+            m_devices.push_back(devices);
+            return m_devices.size() - 1;
+        }
+        int index = m_free.back();
+        m_free.pop_back();
+        m_devices[index] = devices;
+        return index;
+    }
+    
+    /**
+     * @brief Takes a device vector out of the table, freeing its slot.
+     * @param index The index of the device vector.
+     * @return The device vector.
+     */
+    DeviceVector take(int index) {
+        m_free.push_back(index);
+        return m_devices[index];
+    }
+    
+private:
+    std::vector<DeviceVector> m_devices;
+    std::vector<int> m_free; ///< Indexes of the free slots
+};
+
+/**
+ * @brief The payload of a job arrival; see JobArrivalEvent. The job arrives at 
+ * the time of the record.
+ */
+struct JobArrivalRecord {
+    int job_number; ///< The number of the job that arrives in the system.
+    int max_memory; ///< The maximum memory required by the job.
+    int max_devices; ///< The index of the job's maximum claim in the RecordDeviceTable.
+    int runtime; ///< The runtime of the job.
+    int priority; ///< The priority of the job.
+};
+
+/** @brief The payload of a device request; see DeviceRequestEvent. */
+struct DeviceRequestRecord {
+    int job_number; ///< The number of the job that requests the devices.
+    int requested_devices; ///< The index of the devices requested in the RecordDeviceTable.
+};
+
+/** @brief The payload of a device release; see DeviceReleaseEvent. */
+struct DeviceReleaseRecord {
+    int job_number; ///< The number of the job that releases the devices.
+    int released_devices; ///< The index of the devices released in the RecordDeviceTable.
+};
+
+/** @brief The payload of a display; see DisplayEvent. */
+struct DisplayRecord {
+    const std::string* filename; ///< The output file prefix; must outlive the record.
+};
+
+/**
+ * @class EventRecord
+ * @brief An event held by value as a tagged variant of the closed set of event kinds.
+ * 
+ * EventRecord is the devirtualized counterpart of the Event class hierarchy. Records 
+ * are small (the largest payload is five ints, as device vectors are kept in the 
+ * system's RecordDeviceTable), trivially copyable and stored directly in the 
+ * event queue, and are processed with a switch over the variant instead of a 
+ * virtual call. Processing 
+ * is delegated to the same static handle() functions used by the Event subclasses, 
+ * so both representations behave identically. Quantum ends are not records; they 
+ * are CPU timers of the SystemState.
+ */
+class EventRecord {
+public:
+    /** The payload of the record. */
+    using Body = std::variant<JobArrivalRecord, DeviceRequestRecord, DeviceReleaseRecord, 
+                              DisplayRecord>;
+    
+    /**
+     * @brief Constructs an EventRecord.
+     * @param time The time at which the event occurs.
+     * @param body The payload of the event.
+     */
+    EventRecord(int time, const Body& body);
+    
+    /**
+     * @brief Processes the event and updates the system state.
+     * @param state The current system state.
+     */
+    void process(SystemState& state) const;
+    
+    /**
+     * @brief Gets the time at which the event occurs.
+     * @return The time at which the event occurs.
+     */
+    int get_time() const;
+    
+    /**
+     * @brief Gets the type of the event.
+     * @return Type::External, as records are only made for input commands.
+     */
+    Event::Type get_type() const;
+    
+    /**
+     * @brief Gets the kind of the event.
+     * @return The kind of the event.
+     */
+    Event::Kind get_kind() const;
+    
+private:
+    int m_time; ///< The time at which the event occurs.
+    Body m_body; ///< The payload of the event.
+};
+
+#endif // _EVENT_RECORD_H_
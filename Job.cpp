@@ -6,15 +6,15 @@
  * @param arrival_time The arrival time of the job.
  * @param number The job number.
  * @param max_memory The maximum memory required by the job.
- * @param max_devices The maximum number of devices required by the job.
+ * @param max_devices The maximum number of devices of each class required by the job.
  * @param runtime The runtime of the job.
  * @param priority The priority of the job.
  */
-Job::Job(int arrival_time, int number, int max_memory, int max_devices, 
+Job::Job(int arrival_time, int number, int max_memory, const DeviceVector& max_devices, 
          int runtime, int priority)
 : m_arrival_time(arrival_time), m_number(number), m_max_memory(max_memory), 
   m_max_devices(max_devices), m_runtime(runtime), m_priority(priority), 
-  m_allocated_devices(0), m_time_remaining(runtime), m_requested_devices(0),
+  m_allocated_devices(), m_time_remaining(runtime), m_requested_devices(),
   m_completion_time(0) {
 }
     
@@ -30,7 +30,7 @@ int Job::get_max_memory() const {
     return m_max_memory;
 }
 
-int Job::get_max_devices() const {
+const DeviceVector& Job::get_max_devices() const {
     return m_max_devices;
 }
 
@@ -42,28 +42,28 @@ int Job::get_priority() const {
     return m_priority;
 }
 
-int Job::get_allocated_devices() const {
+const DeviceVector& Job::get_allocated_devices() const {
     return m_allocated_devices;
 }
 
-void Job::set_allocated_devices(int allocated_devices) {
+void Job::set_allocated_devices(const DeviceVector& allocated_devices) {
     m_allocated_devices = allocated_devices;
 }
 
-int Job::get_requested_devices() const {
+const DeviceVector& Job::get_requested_devices() const {
     return m_requested_devices;
 }
 
-void Job::set_requested_devices(int requested_devices) {
+void Job::set_requested_devices(const DeviceVector& requested_devices) {
     m_requested_devices = requested_devices;
 }
 
 void Job::allocate_requested_devices() {
     set_allocated_devices(get_allocated_devices() + get_requested_devices());
-    set_requested_devices(0);
+    set_requested_devices(DeviceVector());
 }
 
-void Job::release_devices(int devices) {
+void Job::release_devices(const DeviceVector& devices) {
     m_allocated_devices -= devices;
 }
 
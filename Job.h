@@ -1,6 +1,8 @@
 #ifndef _JOB_H_
 #define _JOB_H_
 
+#include "DeviceVector.h"
+
 /**
  * @brief The Job class represents a job in a scheduling simulator.
  */
@@ -11,11 +13,12 @@ public:
      * @param arrival_time The arrival time of the job.
      * @param number The job number.
      * @param max_memory The maximum memory required by the job.
-     * @param max_devices The maximum number of devices required by the job.
+     * @param max_devices The maximum number of devices of each class required by the job.
      * @param runtime The runtime of the job.
      * @param priority The priority of the job.
      */
-    Job(int arrival_time, int number, int max_memory, int max_devices, int runtime, int priority);
+    Job(int arrival_time, int number, int max_memory, const DeviceVector& max_devices, 
+        int runtime, int priority);
     
     /**
      * @brief Gets the arrival time of the job.
@@ -36,10 +39,10 @@ public:
     int get_max_memory() const;
     
     /**
-     * @brief Gets the maximum number of devices required by the job.
+     * @brief Gets the maximum number of devices of each class required by the job.
      * @return The maximum number of devices.
      */
-    int get_max_devices() const;
+    const DeviceVector& get_max_devices() const;
     
     /**
      * @brief Gets the runtime of the job.
@@ -57,25 +60,25 @@ public:
      * @brief Gets the number of devices allocated to the job.
      * @return The number of allocated devices.
      */
-    int get_allocated_devices() const;
+    const DeviceVector& get_allocated_devices() const;
     
     /**
      * @brief Sets the number of devices allocated to the job.
      * @param allocated_devices The number of allocated devices.
      */
-    void set_allocated_devices(int allocated_devices);
+    void set_allocated_devices(const DeviceVector& allocated_devices);
     
     /**
      * @brief Gets the number of devices requested by the job.
      * @return The number of requested devices.
      */
-    int get_requested_devices() const;
+    const DeviceVector& get_requested_devices() const;
     
     /**
      * @brief Sets the number of devices requested by the job.
      * @param requested_devices The number of requested devices.
      */
-    void set_requested_devices(int requested_devices);
+    void set_requested_devices(const DeviceVector& requested_devices);
     
     /**
      * @brief Allocates the requested devices to the job.
@@ -86,7 +89,7 @@ public:
      * @brief Releases the specified number of devices from the job.
      * @param devices The number of devices to release.
      */
-    void release_devices(int devices);
+    void release_devices(const DeviceVector& devices);
     
     /**
      * @brief Gets the remaining time for the job to complete.
@@ -125,14 +128,14 @@ private:
     int m_arrival_time;
     int m_number;
     int m_max_memory;
-    int m_max_devices;
+    DeviceVector m_max_devices;
     int m_runtime;
     int m_priority;
     
-    int m_allocated_devices;
+    DeviceVector m_allocated_devices;
     int m_time_remaining;
     int m_accrued_time;
-    int m_requested_devices;
+    DeviceVector m_requested_devices;
     int m_completion_time;
 };
 
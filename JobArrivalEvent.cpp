@@ -4,6 +4,7 @@
 
 #include "JobArrivalEvent.h"
 #include "SystemState.h"
+#include "Trace.h"
 
 using namespace std;
 
@@ -22,27 +23,29 @@ JobArrivalEvent::JobArrivalEvent(int time, Job job)
  * @param state The current system state.
  */
 void JobArrivalEvent::process(SystemState& state) {
-    cout << get_time() << ": Job arrival" << endl;
-    if (m_job.get_max_memory() > state.get_max_memory() 
-        || m_job.get_max_devices() > state.get_max_devices()) {
-        cerr << "Job " << m_job.get_number() 
+    handle(state, get_time(), m_job);
+}
+
+void JobArrivalEvent::handle(SystemState& state, int time, const Job& job) {
+    TRACE(TraceLevel::Events, time << ": Job arrival");
+    if (job.get_max_memory() > state.get_max_memory() 
+        || job.get_max_devices().any_greater(state.get_max_devices())) {
+        cerr << "Job " << job.get_number() 
              << " rejected due to insufficient total system resources." 
              << endl;
+        TRACE_DECISION(time, Trace::Decision::Rejected, job.get_number());
         return;
-    } else if (m_job.get_max_memory() > state.get_available_memory()) {
-        if (m_job.get_priority() == 1) {
-            state.add_job(m_job);
-            state.schedule_job(SystemState::JobQueue::Hold1, m_job.get_number());
-        } else if (m_job.get_priority() == 2) {
-            state.add_job(m_job);
-            state.schedule_job(SystemState::JobQueue::Hold2, m_job.get_number());
+    } else if (job.get_max_memory() > state.get_available_memory()) {
+        if (job.get_priority() == 1) {
+            state.schedule_job(SystemState::JobQueue::Hold1, state.add_job(job));
+        } else if (job.get_priority() == 2) {
+            state.schedule_job(SystemState::JobQueue::Hold2, state.add_job(job));
         } else {
             throw runtime_error("Error: Invalid job priority.");
         }
     } else {
-        state.allocate_memory(m_job.get_max_memory());
-        state.add_job(m_job);
-        state.schedule_job(SystemState::JobQueue::Ready, m_job.get_number());
+        state.allocate_memory(job.get_max_memory());
+        state.schedule_job(SystemState::JobQueue::Ready, state.add_job(job));
     }
 }
 
@@ -50,3 +53,6 @@ Event::Type JobArrivalEvent::get_type() const {
     return Event::Type::External;
 }
 
+Event::Kind JobArrivalEvent::get_kind() const {
+    return Event::Kind::JobArrival;
+}
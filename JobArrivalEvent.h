@@ -29,11 +29,25 @@ public:
      */
     void process(SystemState& state);
     
+    /**
+     * @brief Handles a job arrival; shared by JobArrivalEvent and JobArrivalRecord.
+     * @param state The current system state.
+     * @param time The arrival time of the job.
+     * @param job The job that arrives in the system.
+     */
+    static void handle(SystemState& state, int time, const Job& job);
+    
     /**
      * @brief Get the type of the event.
      * @return The type of the event.
      */
     Type get_type() const;
+    
+    /**
+     * @brief Gets the kind of the event.
+     * @return Kind::JobArrival.
+     */
+    Kind get_kind() const;
 
 private:
     Job m_job; ///< The job that arrives in the system.
@@ -0,0 +1,74 @@
+#include "JobTable.h"
+
+using namespace std;
+
+JobTable::JobTable() 
+: m_slots(), m_free_slots(), m_number(), m_arrival_time(), m_max_memory(), 
+  m_max_devices(), m_runtime(), m_priority(), m_allocated_devices(), 
+  m_requested_devices(), m_time_remaining(), m_completion_time(), m_start_time(), 
+  m_queue_entries(), m_queue_entry_times() {
+}
+
+int JobTable::add(const Job& job) {
+    int slot;
+    if (!m_free_slots.empty()) {
+        slot = m_free_slots.back();
+    } else {
+        slot = m_number.size();
+    }
+    pair<unordered_map<int, int>::iterator, bool> inserted = 
+        m_slots.emplace(job.get_number(), slot);
+    if (!inserted.second) {
+        // A job with this number is already present and is kept as it is
+        return inserted.first->second;
+    }
+    
+    if (slot == (int) m_number.size()) {
+        m_number.push_back(0);
+        m_arrival_time.push_back(0);
+        m_max_memory.push_back(0);
+        m_max_devices.push_back(DeviceVector());
+        m_runtime.push_back(0);
+        m_priority.push_back(0);
+        m_allocated_devices.push_back(DeviceVector());
+        m_requested_devices.push_back(DeviceVector());
+        m_time_remaining.push_back(0);
+        m_completion_time.push_back(0);
+        m_start_time.push_back(0);
+        m_queue_entries.push_back({});
+        m_queue_entry_times.push_back({});
+    } else {
+        m_free_slots.pop_back();
+    }
+    m_number[slot] = job.get_number();
+    m_arrival_time[slot] = job.get_arrival_time();
+    m_max_memory[slot] = job.get_max_memory();
+    m_max_devices[slot] = job.get_max_devices();
+    m_runtime[slot] = job.get_runtime();
+    m_priority[slot] = job.get_priority();
+    m_allocated_devices[slot] = job.get_allocated_devices();
+    m_requested_devices[slot] = job.get_requested_devices();
+    m_time_remaining[slot] = job.get_time_remaining();
+    m_completion_time[slot] = job.get_completion_time();
+    m_start_time[slot] = NotStarted;
+    m_queue_entries[slot].fill(0);
+    return slot;
+}
+
+void JobTable::remove(int slot) {
+    m_slots.erase(m_number[slot]);
+    m_free_slots.push_back(slot);
+}
+
+int JobTable::find(int number) const {
+    unordered_map<int, int>::const_iterator it = m_slots.find(number);
+    return (it == m_slots.end()) ? NoJob : it->second;
+}
+
+size_t JobTable::size() const {
+    return m_slots.size();
+}
+
+const unordered_map<int, int>& JobTable::get_slots() const {
+    return m_slots;
+}
@@ -0,0 +1,158 @@
+#ifndef _JOB_TABLE_H_
+#define _JOB_TABLE_H_
+
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <cstddef>
+
+#include "Job.h"
+
+/**
+ * @class JobTable
+ * @brief Stores the jobs in the system as parallel arrays indexed by slot.
+ * 
+ * Each job is given a dense slot index when it arrives, and its attributes are 
+ * kept in one array per attribute, so that the scheduler's scans over queues of 
+ * slots read packed integers instead of hashing job numbers. The job number is 
+ * only mapped to a slot when a job arrives or an input command names it.
+ * 
+ * Slots of removed jobs are reused by later arrivals.
+ * 
+ * The table also records which queues each job is in, and when it last entered 
+ * each of them, so that a job's location is found without searching the 
+ * queues. Queues are numbered by the caller (SystemState::JobQueue, in the 
+ * order in which displays look for a job). A job can be in several queues at 
+ * once, and more than once in the same queue, so an entry count is kept per 
+ * queue.
+ */
+class JobTable {
+public:
+    static constexpr int MAX_QUEUES = 8;
+    static constexpr int NoQueue = -1;
+    static constexpr int NotStarted = -1;
+    
+    JobTable();
+    
+    /**
+     * @brief Adds a job, unless a job with the same number is already present.
+     * @param job The job to add.
+     * @return The slot of the job with that number.
+     */
+    int add(const Job& job);
+    
+    /**
+     * @brief Removes a job and frees its slot.
+     * @param slot The slot of the job.
+     */
+    void remove(int slot);
+    
+    /**
+     * @brief Finds the slot of a job number.
+     * @param number The job number.
+     * @return The slot of the job, or NoJob if there is no such job.
+     */
+    int find(int number) const;
+    
+    /**
+     * @brief Gets the number of jobs in the table.
+     */
+    std::size_t size() const;
+    
+    /**
+     * @brief Gets the slots of all jobs, keyed by job number.
+     * 
+     * Displays list jobs in the iteration order of this map, which is the order 
+     * of the unordered_map<int, Job> the table replaced.
+     */
+    const std::unordered_map<int, int>& get_slots() const;
+    
+    int get_number(int slot) const { return m_number[slot]; }
+    int get_arrival_time(int slot) const { return m_arrival_time[slot]; }
+    int get_max_memory(int slot) const { return m_max_memory[slot]; }
+    const DeviceVector& get_max_devices(int slot) const { return m_max_devices[slot]; }
+    int get_runtime(int slot) const { return m_runtime[slot]; }
+    int get_priority(int slot) const { return m_priority[slot]; }
+    const DeviceVector& get_allocated_devices(int slot) const { 
+        return m_allocated_devices[slot]; 
+    }
+    const DeviceVector& get_requested_devices(int slot) const { 
+        return m_requested_devices[slot]; 
+    }
+    int get_time_remaining(int slot) const { return m_time_remaining[slot]; }
+    int get_completion_time(int slot) const { return m_completion_time[slot]; }
+    
+    /** @brief Gets the time a job was first put on the CPU, or NotStarted. */
+    int get_start_time(int slot) const { return m_start_time[slot]; }
+    
+    void set_requested_devices(int slot, const DeviceVector& requested_devices) {
+        m_requested_devices[slot] = requested_devices;
+    }
+    
+    void allocate_requested_devices(int slot) {
+        m_allocated_devices[slot] += m_requested_devices[slot];
+        m_requested_devices[slot] = DeviceVector();
+    }
+    
+    void release_devices(int slot, const DeviceVector& devices) {
+        m_allocated_devices[slot] -= devices;
+    }
+    
+    void step_time(int slot, int time) {
+        m_time_remaining[slot] -= time;
+    }
+    
+    void set_completion_time(int slot, int time) {
+        m_completion_time[slot] = time;
+    }
+    
+    void set_start_time(int slot, int time) {
+        m_start_time[slot] = time;
+    }
+    
+    void enter_queue(int slot, int queue, int time) { 
+        m_queue_entries[slot][queue]++; 
+        m_queue_entry_times[slot][queue] = time;
+    }
+    void leave_queue(int slot, int queue) { m_queue_entries[slot][queue]--; }
+    bool is_in_queue(int slot, int queue) const { return m_queue_entries[slot][queue] > 0; }
+    
+    /** @brief Gets the time a job last entered a queue. */
+    int get_queue_entry_time(int slot, int queue) const { 
+        return m_queue_entry_times[slot][queue]; 
+    }
+    
+    /**
+     * @brief Gets the lowest-numbered queue that a job is in.
+     * @param slot The slot of the job.
+     * @return The queue, or NoQueue if the job is in none.
+     */
+    int get_first_queue(int slot) const {
+        for (int queue = 0; queue < MAX_QUEUES; queue++) {
+            if (m_queue_entries[slot][queue] > 0) {
+                return queue;
+            }
+        }
+        return NoQueue;
+    }
+
+private:
+    std::unordered_map<int, int> m_slots;
+    std::vector<int> m_free_slots;
+    
+    std::vector<int> m_number;
+    std::vector<int> m_arrival_time;
+    std::vector<int> m_max_memory;
+    std::vector<DeviceVector> m_max_devices;
+    std::vector<int> m_runtime;
+    std::vector<int> m_priority;
+    std::vector<DeviceVector> m_allocated_devices;
+    std::vector<DeviceVector> m_requested_devices;
+    std::vector<int> m_time_remaining;
+    std::vector<int> m_completion_time;
+    std::vector<int> m_start_time;
+    std::vector<std::array<int, MAX_QUEUES>> m_queue_entries;
+    std::vector<std::array<int, MAX_QUEUES>> m_queue_entry_times;
+};
+
+#endif // _JOB_TABLE_H_
@@ -0,0 +1,36 @@
+#include "LatencyHistogram.h"
+
+using namespace std;
+
+LatencyHistogram::LatencyHistogram() : m_counts(), m_count(0), m_max(0) {
+}
+
+/**
+ * Gets the largest value that falls into a bucket.
+ */
+int LatencyHistogram::get_bucket_top(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    int shift = (bucket - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+    long bottom = (long) ((bucket - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS) << shift;
+    return bottom + (1L << shift) - 1;
+}
+
+int LatencyHistogram::get_percentile(int per_mille) const {
+    if (m_count == 0) {
+        return 0;
+    }
+    // The rank of the value, counting from 1 (nearest-rank method)
+    unsigned long rank = (per_mille * m_count + 999) / 1000;
+    rank = (rank < 1) ? 1 : rank;
+    unsigned long seen = 0;
+    for (int bucket = 0; bucket < BUCKETS; bucket++) {
+        seen += m_counts[bucket];
+        if (seen >= rank) {
+            int top = get_bucket_top(bucket);
+            return (top < m_max) ? top : m_max;
+        }
+    }
+    return m_max;
+}
@@ -0,0 +1,72 @@
+#ifndef _LATENCY_HISTOGRAM_H_
+#define _LATENCY_HISTOGRAM_H_
+
+#include <array>
+
+/**
+ * @class LatencyHistogram
+ * @brief Counts durations in logarithmic buckets of fixed memory, for percentiles.
+ *
+ * The buckets are laid out as in an HDR histogram: values below 2^SUB_BUCKET_BITS
+ * have a bucket each, and every higher power of two range is split into
+ * 2^(SUB_BUCKET_BITS - 1) equal buckets, so a value is known to within 1/64 of
+ * itself. Recording a value only increments a counter, and the whole range of
+ * int fits into a fixed array.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 7;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+    static constexpr int BUCKETS = SUB_BUCKETS + (31 - SUB_BUCKET_BITS) * HALF_SUB_BUCKETS;
+    
+    LatencyHistogram();
+    
+    /** @brief Counts a duration; negative durations count as 0. */
+    void record(int value) {
+        value = (value < 0) ? 0 : value;
+        m_counts[get_bucket(value)]++;
+        m_count++;
+        m_max = (value > m_max) ? value : m_max;
+    }
+    
+    /**
+     * @brief Uncounts a duration that was recorded before. The maximum is kept,
+     * so it is an upper bound afterwards.
+     */
+    void remove(int value) {
+        value = (value < 0) ? 0 : value;
+        m_counts[get_bucket(value)]--;
+        m_count--;
+    }
+    
+    unsigned long count() const { return m_count; }
+    int max() const { return m_max; }
+    
+    /**
+     * @brief Gets the smallest duration that a given share of the recorded
+     * durations do not exceed, rounded up to the top of its bucket.
+     * @param per_mille The share in thousandths, such as 999 for p99.9.
+     * @return The duration, or 0 if none were recorded.
+     */
+    int get_percentile(int per_mille) const;
+
+private:
+    std::array<unsigned long, BUCKETS> m_counts;
+    unsigned long m_count;
+    int m_max;
+    
+    static int get_bucket(int value) {
+        if (value < SUB_BUCKETS) {
+            return value;
+        }
+        int exponent = 31 - __builtin_clz(value);
+        int shift = exponent - SUB_BUCKET_BITS + 1;
+        return SUB_BUCKETS + (exponent - SUB_BUCKET_BITS) * HALF_SUB_BUCKETS
+               + (value >> shift) - HALF_SUB_BUCKETS;
+    }
+    
+    static int get_bucket_top(int bucket);
+};
+
+#endif // _LATENCY_HISTOGRAM_H_
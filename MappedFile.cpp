@@ -0,0 +1,45 @@
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "MappedFile.h"
+
+using namespace std;
+
+MappedFile::MappedFile(const string& path) 
+: m_data(nullptr), m_size(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Error: Could not find specified input file.");
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throw runtime_error("Error: Could not read specified input file.");
+    }
+    m_size = st.st_size;
+    if (m_size > 0) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            throw runtime_error("Error: Could not read specified input file.");
+        }
+        // The input is read front to back exactly once
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(data);
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+string_view MappedFile::contents() const {
+    return string_view(m_data, m_size);
+}
@@ -0,0 +1,40 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * @class MappedFile
+ * @brief A read-only memory mapping of a whole file.
+ * 
+ * The file is mapped for the lifetime of the object, so views into contents() 
+ * stay valid until it is destroyed.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Maps a file into memory.
+     * @param path The path of the file to map.
+     * @throws runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path);
+    
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+    
+    /**
+     * @brief Gets the contents of the file.
+     * @return A view of the mapped bytes.
+     */
+    std::string_view contents() const;
+    
+private:
+    const char* m_data; ///< The start of the mapping, or nullptr for an empty file.
+    std::size_t m_size; ///< The size of the file in bytes.
+};
+
+#endif // _MAPPED_FILE_H_
@@ -0,0 +1,125 @@
+#include <stdexcept>
+#include <string>
+#include <cstdlib>
+
+#include "Options.h"
+
+using namespace std;
+
+void split_option(const string& arg, string& name, string& value) {
+    string::size_type equals = arg.find('=');
+    if (equals == string::npos) {
+        name = arg;
+        value = "";
+    } else {
+        name = arg.substr(0, equals);
+        value = arg.substr(equals + 1);
+    }
+}
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 2; i < argc; i++) {
+        string name;
+        string value;
+        split_option(argv[i], name, value);
+        if (name == "--event-order") {
+            if (value == "fifo") {
+                options.event_order = TieOrder::Fifo;
+            } else if (value == "lifo") {
+                options.event_order = TieOrder::Lifo;
+            } else {
+                throw runtime_error("Error: --event-order must be fifo or lifo.");
+            }
+        } else if (name == "--engine") {
+            if (value == "virtual") {
+                options.engine = EventEngine::Virtual;
+            } else if (value == "variant") {
+                options.engine = EventEngine::Variant;
+            } else {
+                throw runtime_error("Error: --engine must be virtual or variant.");
+            }
+        } else if (name == "--policy") {
+            if (value == "round-robin") {
+                options.policy = SchedulingPolicy::RoundRobin;
+            } else if (value == "priority") {
+                options.policy = SchedulingPolicy::Priority;
+            } else if (value == "srtf") {
+                options.policy = SchedulingPolicy::ShortestRemaining;
+            } else if (value == "sjf") {
+                options.policy = SchedulingPolicy::ShortestJob;
+            } else if (value == "mlfq") {
+                options.policy = SchedulingPolicy::Multilevel;
+            } else {
+                throw runtime_error("Error: --policy must be round-robin, priority, srtf, sjf or mlfq.");
+            }
+        } else if (name == "--trace") {
+            if (value == "none") {
+                options.trace_level = TraceLevel::None;
+            } else if (value == "events") {
+                options.trace_level = TraceLevel::Events;
+            } else if (value == "decisions") {
+                options.trace_level = TraceLevel::Decisions;
+            } else if (value == "all") {
+                options.trace_level = TraceLevel::Time;
+            } else {
+                throw runtime_error("Error: --trace must be none, events, decisions or all.");
+            }
+        } else if (name == "--trace-decisions") {
+            int capacity = atoi(value.c_str());
+            if (capacity < 1) {
+                throw runtime_error("Error: --trace-decisions must be a positive number.");
+            }
+            if (!TRACE_DECISIONS) {
+                throw runtime_error("Error: --trace-decisions is not compiled in "
+                                    "(rebuild with make TRACE_DECISIONS=1).");
+            }
+            options.trace_decisions = capacity;
+        } else if (name == "--fire-stale-timers") {
+            options.fire_stale_timers = true;
+        } else if (name == "--batch") {
+            options.batch = true;
+        } else if (name == "--stats") {
+            options.stats = true;
+        } else if (name == "--stream") {
+            options.stream = true;
+        } else if (name == "--parse-only") {
+            options.parse_only = true;
+        } else if (name == "--parse-threads") {
+            int threads = atoi(value.c_str());
+            if (threads < 1) {
+                throw runtime_error("Error: --parse-threads must be a positive number.");
+            }
+            options.parse_threads = threads;
+        } else if (name == "--bankers-inclusive") {
+            options.bankers_inclusive = true;
+        } else if (name == "--check-bankers") {
+            options.check_bankers = true;
+        } else if (name == "--async-display") {
+            options.async_display = true;
+        } else if (name == "--display-queue") {
+            int capacity = atoi(value.c_str());
+            if (capacity < 1) {
+                throw runtime_error("Error: --display-queue must be a positive number.");
+            }
+            options.display_queue = capacity;
+        } else if (name == "--turnaround-stats") {
+            options.turnaround_stats = true;
+        } else if (name == "--latency-stats") {
+            options.latency_stats = true;
+        } else if (name == "--delta-display") {
+            options.delta_display = true;
+        } else if (name == "--display-overflow") {
+            if (value == "block") {
+                options.display_overflow = DisplayOverflow::Block;
+            } else if (value == "drop") {
+                options.display_overflow = DisplayOverflow::Drop;
+            } else {
+                throw runtime_error("Error: --display-overflow must be block or drop.");
+            }
+        } else {
+            throw runtime_error("Error: Unknown option " + name);
+        }
+    }
+    return options;
+}
@@ -0,0 +1,154 @@
+#ifndef _OPTIONS_H_
+#define _OPTIONS_H_
+
+#include <cstddef>
+#include <string>
+
+#include "EventQueue.h"
+#include "Trace.h"
+
+/**
+ * @enum EventEngine
+ * @brief How pending events are represented in the event queue.
+ */
+enum class EventEngine {
+    Virtual, /**< Pooled Event objects, processed through virtual calls. */
+    Variant, /**< EventRecord values stored in the queue, processed with a switch. */
+};
+
+/**
+ * @enum SchedulingPolicy
+ * @brief The policy of the scheduling passes (see SchedulingPolicies.h).
+ */
+enum class SchedulingPolicy {
+    RoundRobin,        /**< First come, first served in the ready queue (RoundRobinPolicy). */
+    Priority,          /**< Best priority first in the ready queue (PriorityPolicy). */
+    ShortestRemaining, /**< Least time remaining first (ShortestRemainingPolicy). */
+    ShortestJob,       /**< Least runtime first (ShortestJobPolicy). */
+    Multilevel,        /**< Multilevel feedback queue (MultilevelFeedbackPolicy). */
+};
+
+/**
+ * @enum DisplayOverflow
+ * @brief What an asynchronous display does when the snapshot writer's queue is full.
+ */
+enum class DisplayOverflow {
+    Block, /**< Wait for the writer thread to make room. */
+    Drop,  /**< Skip the display's tables and JSON file. */
+};
+
+/**
+ * @struct Options
+ * @brief Run-time settings for the simulator, parsed from the command line.
+ * 
+ * Every option defaults to the simulator's standard behavior, so running with no 
+ * options is always valid.
+ */
+struct Options {
+    /** The order in which equal-time events of the same type are processed. */
+    TieOrder event_order = TieOrder::Fifo;
+    
+    /** How pending events are represented in the event queue. */
+    EventEngine engine = EventEngine::Virtual;
+    
+    /** Which job goes on the CPU next, and the other decisions of update_queues(). */
+    SchedulingPolicy policy = SchedulingPolicy::RoundRobin;
+    
+    /** 
+     * Whether CPU timers of jobs that left the CPU early still fire. Earlier 
+     * versions of the simulator processed these as quantum ends. 
+     */
+    bool fire_stale_timers = false;
+    
+    /** 
+     * Whether to process events with the same time as a batch, skipping the 
+     * scheduling passes that would not change anything.
+     */
+    bool batch = false;
+    
+    /** 
+     * The most detailed trace lines printed; the default prints all of them, as 
+     * earlier versions did. 
+     */
+    TraceLevel trace_level = TraceLevel::Time;
+    
+    /** The number of last scheduler decisions recorded and printed at exit; 0 for none. */
+    std::size_t trace_decisions = 0;
+    
+    /** Whether to print run statistics to stderr at exit. */
+    bool stats = false;
+    
+    /** 
+     * Whether to retire completed jobs into running turnaround totals instead of 
+     * keeping them in the job table, so that memory use follows the number of 
+     * live jobs rather than the length of the input.
+     */
+    bool stream = false;
+    
+    /** 
+     * Whether every display shows the system turnaround averages and standard 
+     * deviations, which are kept up to date as jobs complete, instead of only 
+     * the final display showing the averages.
+     */
+    bool turnaround_stats = false;
+    
+    /** 
+     * Whether every display shows percentiles of the time jobs spend in the hold, 
+     * ready and device wait queues, until they first run, and until they complete.
+     */
+    bool latency_stats = false;
+    
+    /** Whether to only parse the input file and report the parse speed. */
+    bool parse_only = false;
+    
+    /** The number of threads parsing a text input file; 1 parses it inline. */
+    unsigned int parse_threads = 1;
+    
+    /** 
+     * Whether the banker's safety algorithm lets a job finish when its need equals 
+     * the available devices, instead of only when it is less.
+     */
+    bool bankers_inclusive = false;
+    
+    /** Whether to check every banker's result against the textbook algorithm. */
+    bool check_bankers = false;
+    
+    /** 
+     * Whether displays are rendered and written on a background thread (see 
+     * SnapshotWriter) instead of stalling the simulation.
+     */
+    bool async_display = false;
+    
+    /** The number of displays and console chunks the snapshot writer may queue. */
+    std::size_t display_queue = 4;
+    
+    /** What an asynchronous display does when the queue is full. */
+    DisplayOverflow display_overflow = DisplayOverflow::Block;
+    
+    /** 
+     * Whether display JSON files after the first only hold the changes since the 
+     * previous display (see DisplayWriter).
+     */
+    bool delta_display = false;
+};
+
+/**
+ * @brief Parses the options following the input file on the command line.
+ * 
+ * @param argc The number of command line arguments.
+ * @param argv An array of command line arguments; argv[1] is the input file.
+ * @return The parsed options.
+ * @throws runtime_error if an option is unknown or has an invalid value.
+ */
+Options parse_options(int argc, char** argv);
+
+/**
+ * @brief Splits a "--name=value" argument into its name and value.
+ * 
+ * @param arg The argument to split.
+ * @param name Set to the option name, including the leading dashes.
+ * @param value Set to the option value, or an empty string if there is none.
+ */
+void split_option(const std::string& arg, std::string& name, std::string& value);
+
+#endif // _OPTIONS_H_
@@ -0,0 +1,53 @@
+#include <charconv>
+
+#include "OutputBuffer.h"
+
+using namespace std;
+
+OutputBuffer::OutputBuffer() 
+: m_data() {
+}
+
+OutputBuffer& OutputBuffer::append_int(long value) {
+    NumberBuffer buffer;
+    return append(format_int(buffer, value));
+}
+
+OutputBuffer& OutputBuffer::append_unsigned(unsigned long value) {
+    NumberBuffer buffer;
+    return append(format_unsigned(buffer, value));
+}
+
+OutputBuffer& OutputBuffer::append_fixed(double value) {
+    NumberBuffer buffer;
+    return append(format_fixed(buffer, value));
+}
+
+OutputBuffer& OutputBuffer::append_general(double value) {
+    NumberBuffer buffer;
+    return append(format_general(buffer, value));
+}
+
+string_view OutputBuffer::format_int(NumberBuffer& buffer, long value) {
+    to_chars_result result = to_chars(buffer, buffer + NUMBER_BUFFER_SIZE, value);
+    return string_view(buffer, result.ptr - buffer);
+}
+
+string_view OutputBuffer::format_unsigned(NumberBuffer& buffer, unsigned long value) {
+    to_chars_result result = to_chars(buffer, buffer + NUMBER_BUFFER_SIZE, value);
+    return string_view(buffer, result.ptr - buffer);
+}
+
+// The largest double takes 309 digits before the point in fixed notation, which 
+// fits into NUMBER_BUFFER_SIZE with the sign and the 6 decimals
+string_view OutputBuffer::format_fixed(NumberBuffer& buffer, double value) {
+    to_chars_result result = to_chars(buffer, buffer + NUMBER_BUFFER_SIZE, value, 
+                                      chars_format::fixed, 6);
+    return string_view(buffer, result.ptr - buffer);
+}
+
+string_view OutputBuffer::format_general(NumberBuffer& buffer, double value) {
+    to_chars_result result = to_chars(buffer, buffer + NUMBER_BUFFER_SIZE, value, 
+                                      chars_format::general, 6);
+    return string_view(buffer, result.ptr - buffer);
+}
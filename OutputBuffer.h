@@ -0,0 +1,72 @@
+#ifndef _OUTPUT_BUFFER_H_
+#define _OUTPUT_BUFFER_H_
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * @class OutputBuffer
+ * @brief A growable character buffer that displays are rendered into.
+ * 
+ * clear() keeps the capacity, so a buffer reused across displays stops 
+ * allocating once it has grown to the size of a display. Numbers are formatted 
+ * with std::to_chars, in the same way as std::to_string (fixed) or an ostream with 
+ * default settings (general).
+ */
+class OutputBuffer {
+public:
+    OutputBuffer();
+    
+    void clear() { m_data.clear(); }
+    const char* data() const { return m_data.data(); }
+    std::size_t size() const { return m_data.size(); }
+    std::string_view view() const { return m_data; }
+    
+    OutputBuffer& append(std::string_view s) {
+        m_data.append(s.data(), s.size());
+        return *this;
+    }
+    
+    OutputBuffer& append(char c) {
+        m_data.push_back(c);
+        return *this;
+    }
+    
+    /**
+     * @brief Appends a character a number of times.
+     * @param c The character.
+     * @param count The number of times, which may be 0 or negative for none.
+     */
+    OutputBuffer& append_repeated(char c, long count) {
+        if (count > 0) {
+            m_data.append(static_cast<std::size_t>(count), c);
+        }
+        return *this;
+    }
+    
+    OutputBuffer& append_int(long value);
+    OutputBuffer& append_unsigned(unsigned long value);
+    
+    /** @brief Appends a double as std::to_string does ("%f"). */
+    OutputBuffer& append_fixed(double value);
+    
+    /** @brief Appends a double as an ostream with default settings does ("%g"). */
+    OutputBuffer& append_general(double value);
+    
+    /**
+     * Formatters into a caller's buffer, for measuring a number before writing it. 
+     * Each returns a view of the formatted number inside buffer.
+     */
+    static constexpr std::size_t NUMBER_BUFFER_SIZE = 328;
+    using NumberBuffer = char[NUMBER_BUFFER_SIZE];
+    static std::string_view format_int(NumberBuffer& buffer, long value);
+    static std::string_view format_unsigned(NumberBuffer& buffer, unsigned long value);
+    static std::string_view format_fixed(NumberBuffer& buffer, double value);
+    static std::string_view format_general(NumberBuffer& buffer, double value);
+    
+private:
+    std::string m_data;
+};
+
+#endif // _OUTPUT_BUFFER_H_
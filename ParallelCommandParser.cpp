@@ -0,0 +1,100 @@
+#include <algorithm>
+
+#include "ParallelCommandParser.h"
+#include "CommandParser.h"
+
+using namespace std;
+
+ParallelCommandParser::ParallelCommandParser(string_view input, unsigned int threads, 
+                                             size_t chunk_size) 
+: m_chunks(), m_window(max(threads, 1u) * 4), m_mutex(), m_chunk_ready(), 
+  m_window_open(), m_next_chunk(0), m_current_chunk(0), m_stopping(false), 
+  m_workers(), m_current_ready(false), m_current_command(0) {
+    // Split the input into chunks that end just after a newline
+    size_t begin = 0;
+    while (begin < input.size()) {
+        size_t end = min(begin + max(chunk_size, (size_t) 1), input.size());
+        if (end < input.size()) {
+            size_t newline = input.find('\n', end - 1);
+            end = (newline == string_view::npos) ? input.size() : newline + 1;
+        }
+        m_chunks.push_back(Chunk{ input.substr(begin, end - begin), {}, nullptr, false });
+        begin = end;
+    }
+    
+    for (unsigned int i = 0; i < max(threads, 1u); i++) {
+        m_workers.emplace_back(&ParallelCommandParser::work, this);
+    }
+}
+
+ParallelCommandParser::~ParallelCommandParser() {
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_window_open.notify_all();
+    for (thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Worker loop: claims the next chunk within the window ahead of the reader, 
+ * parses it without holding the lock, and marks it ready.
+ */
+void ParallelCommandParser::work() {
+    unique_lock<mutex> lock(m_mutex);
+    for (;;) {
+        m_window_open.wait(lock, [this] {
+            return m_stopping || m_next_chunk >= m_chunks.size() 
+                   || m_next_chunk < m_current_chunk + m_window;
+        });
+        if (m_stopping || m_next_chunk >= m_chunks.size()) {
+            return;
+        }
+        Chunk& chunk = m_chunks[m_next_chunk++];
+        lock.unlock();
+        
+        CommandParser parser(chunk.text);
+        try {
+            for (Command command; parser.next(command);) {
+                chunk.commands.push_back(command);
+            }
+        } catch (...) {
+            chunk.error = current_exception();
+        }
+        
+        lock.lock();
+        chunk.ready = true;
+        m_chunk_ready.notify_all();
+    }
+}
+
+bool ParallelCommandParser::next(Command& command) {
+    while (m_current_chunk < m_chunks.size()) {
+        Chunk& chunk = m_chunks[m_current_chunk];
+        if (!m_current_ready) {
+            unique_lock<mutex> lock(m_mutex);
+            m_chunk_ready.wait(lock, [&chunk] { return chunk.ready; });
+            m_current_ready = true;
+        }
+        if (m_current_command < chunk.commands.size()) {
+            command = chunk.commands[m_current_command++];
+            return true;
+        }
+        if (chunk.error) {
+            rethrow_exception(chunk.error);
+        }
+        
+        // Done with this chunk; free it and let the workers move ahead
+        vector<Command>().swap(chunk.commands);
+        m_current_ready = false;
+        m_current_command = 0;
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_current_chunk++;
+        }
+        m_window_open.notify_all();
+    }
+    return false;
+}
@@ -0,0 +1,79 @@
+#ifndef _PARALLEL_COMMAND_PARSER_H_
+#define _PARALLEL_COMMAND_PARSER_H_
+
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstddef>
+
+#include "Command.h"
+
+/**
+ * @class ParallelCommandParser
+ * @brief Decodes input lines into Commands on a pool of worker threads.
+ * 
+ * The input is split at line boundaries into chunks, which the workers parse with 
+ * CommandParser into per-chunk command arrays. next() hands the commands out in 
+ * file order, waiting for a chunk if it has not been parsed yet, so the result is 
+ * the same as with a single CommandParser. To bound memory use, workers only run 
+ * a few chunks ahead of the reader, and a chunk's commands are freed once they 
+ * have all been read.
+ * 
+ * If a line is malformed, the commands before it are still returned, and next() 
+ * then throws the parse error.
+ */
+class ParallelCommandParser {
+public:
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE = 4 << 20;
+    
+    /**
+     * @brief Constructs a parser over the given input and starts its workers.
+     * @param input The input; must outlive the parser.
+     * @param threads The number of worker threads.
+     * @param chunk_size The approximate size of a chunk in bytes.
+     */
+    ParallelCommandParser(std::string_view input, unsigned int threads, 
+                          std::size_t chunk_size = DEFAULT_CHUNK_SIZE);
+    ~ParallelCommandParser();
+    
+    ParallelCommandParser(const ParallelCommandParser&) = delete;
+    ParallelCommandParser& operator= (const ParallelCommandParser&) = delete;
+    
+    /**
+     * @brief Gets the next command in file order.
+     * @param command Set to the command.
+     * @return False if there are no more commands, true otherwise.
+     * @throws runtime_error if the line is malformed.
+     */
+    bool next(Command& command);
+    
+private:
+    struct Chunk {
+        std::string_view text;
+        std::vector<Command> commands;
+        std::exception_ptr error;
+        bool ready;
+    };
+    
+    std::vector<Chunk> m_chunks;
+    std::size_t m_window;
+    
+    std::mutex m_mutex;
+    std::condition_variable m_chunk_ready;
+    std::condition_variable m_window_open;
+    std::size_t m_next_chunk;     ///< The next chunk for a worker to parse.
+    std::size_t m_current_chunk;  ///< The chunk being read by next().
+    bool m_stopping;
+    std::vector<std::thread> m_workers;
+    
+    // Only used by the reading thread
+    bool m_current_ready;
+    std::size_t m_current_command;
+    
+    void work();
+};
+
+#endif // _PARALLEL_COMMAND_PARSER_H_
@@ -0,0 +1,76 @@
+#ifndef _RUNNING_STATS_H_
+#define _RUNNING_STATS_H_
+
+#include <cmath>
+
+/**
+ * @class RunningStats
+ * @brief The count, mean and standard deviation of a series of values, kept up to
+ * date as values are added and removed, so reading them takes constant time.
+ *
+ * The spread is kept with Welford's updates, which stay accurate where summing
+ * squares would cancel. The mean is the sum over the count, and the sum is kept
+ * with Neumaier's compensated summation, so that it does not depend on the order
+ * in which the values were added (and is exact for integers).
+ */
+class RunningStats {
+public:
+    RunningStats() : m_count(0), m_sum(0), m_compensation(0), m_mean(0), m_squares(0) {
+    }
+    
+    void add(double value) {
+        m_count++;
+        accumulate(value);
+        double delta = value - m_mean;
+        m_mean += delta / m_count;
+        m_squares += delta * (value - m_mean);
+    }
+    
+    /** @brief Removes a value that was added before, undoing its add(). */
+    void remove(double value) {
+        m_count--;
+        accumulate(-value);
+        if (m_count == 0) {
+            m_mean = 0;
+            m_squares = 0;
+            return;
+        }
+        double delta = value - m_mean;
+        m_mean -= delta / m_count;
+        m_squares -= delta * (value - m_mean);
+    }
+    
+    unsigned long count() const { return m_count; }
+    double sum() const { return m_sum + m_compensation; }
+    
+    /** @brief Gets the mean; NaN if there are no values. */
+    double mean() const { return sum() / (double) m_count; }
+    
+    /** @brief Gets the population standard deviation; NaN if there are no values. */
+    double standard_deviation() const {
+        if (m_count == 0) {
+            return NAN;
+        }
+        // Removing values can leave a rounding error just below 0
+        return (m_squares > 0) ? std::sqrt(m_squares / m_count) : 0;
+    }
+
+private:
+    unsigned long m_count;
+    double m_sum;
+    double m_compensation; ///< The rounding error lost from m_sum so far.
+    double m_mean;         ///< The running mean of Welford's updates.
+    double m_squares;      ///< The sum of squared differences from the mean.
+    
+    void accumulate(double value) {
+        double sum = m_sum + value;
+        if (std::fabs(m_sum) >= std::fabs(value)) {
+            m_compensation += (m_sum - sum) + value;
+        } else {
+            m_compensation += (value - sum) + m_sum;
+        }
+        m_sum = sum;
+    }
+};
+
+#endif // _RUNNING_STATS_H_
@@ -0,0 +1,191 @@
+#ifndef _SCHEDULING_POLICIES_H_
+#define _SCHEDULING_POLICIES_H_
+
+#include "SystemState.h"
+
+/*
+ * The scheduling policies of SystemState. A policy is a type with static
+ * members, passed to the scheduling code as a template parameter, so its
+ * decisions are inlined rather than called through a function pointer or
+ * virtual call:
+ *
+ *   static constexpr const char* NAME;
+ *       The name of the policy in the statistics, as given to --policy.
+ *   static int order_hold_1(const SystemState& state, int job_id);
+ *       The key that orders hold queue 1, smallest first (newest first among
+ *       equal keys).
+ *   static int order_hold_2(const SystemState& state, int job_id);
+ *       The key that orders hold queue 2, smallest first (first come, first
+ *       served among equal keys).
+ *   static constexpr bool ORDER_READY;
+ *       Whether the ready queue is ordered by order_ready(); if not, it is
+ *       first come, first served.
+ *   static int order_ready(const SystemState& state, int job_id);
+ *       The key that orders the ready queue, smallest first (first come, first
+ *       served among equal keys). The job with the smallest key goes on the
+ *       CPU. Only needed if ORDER_READY.
+ *   static int quantum(const SystemState& state, int job_id);
+ *       How long a job put on the CPU may run before it is taken off again
+ *       (at most its time remaining is used).
+ *   static constexpr bool DEMOTE_LONG_JOBS;
+ *       Whether jobs that ran for the time excess move to the long queue.
+ *   static bool promote_long_job(const SystemState& state, int job_id,
+ *                                bool holds_empty, bool cpu_idle,
+ *                                bool jobs_ready);
+ *       Whether a job in the long queue moves back to the ready queue now.
+ *   static bool grant_devices(const SystemState& state, int job_id);
+ *       Whether the device request of an active job is granted now.
+ *
+ * The keys of a job are taken when it enters the queue, and must not change
+ * while it is there. The queues are ShortestJobQueues, so every insertion and
+ * every pick takes O(log n).
+ */
+
+/**
+ * @struct RoundRobinPolicy
+ * @brief The standard policy: the ready queue is first come, first served, long
+ * jobs are demoted, and requests are granted by the banker's algorithm.
+ */
+struct RoundRobinPolicy {
+    static constexpr const char* NAME = "round-robin";
+    
+    // Hold queue 1 is shortest job first, hold queue 2 first come, first served
+    static int order_hold_1(const SystemState& state, int job_id) {
+        return state.get_jobs().get_runtime(job_id);
+    }
+    
+    static int order_hold_2(const SystemState&, int) {
+        return 0;
+    }
+    
+    // The ready queue stays a plain queue, which needs no ordering at all
+    static constexpr bool ORDER_READY = false;
+    
+    static int quantum(const SystemState& state, int) {
+        return state.get_quantum_length();
+    }
+    
+    static constexpr bool DEMOTE_LONG_JOBS = true;
+    
+    // A long job only goes back once nothing else waits for memory and the 
+    // ready queue has work besides it. SystemState::needs_update() relies on 
+    // promotion needing an idle CPU with jobs ready, so a policy that promotes 
+    // in other states must also change that check.
+    static bool promote_long_job(const SystemState&, int, bool holds_empty, bool cpu_idle, bool jobs_ready) {
+        return holds_empty && cpu_idle && jobs_ready;
+    }
+    
+    static bool grant_devices(const SystemState& state, int job_id) {
+        return state.bankers_valid(job_id);
+    }
+};
+
+/**
+ * @struct PriorityPolicy
+ * @brief Like RoundRobinPolicy, but the ready job of the best priority (the
+ * lowest P) goes on the CPU first, in first come, first served order among
+ * equals.
+ */
+struct PriorityPolicy : RoundRobinPolicy {
+    static constexpr const char* NAME = "priority";
+    
+    static constexpr bool ORDER_READY = true;
+    
+    static int order_ready(const SystemState& state, int job_id) {
+        return state.get_jobs().get_priority(job_id);
+    }
+};
+
+/**
+ * @struct ShortestRemainingPolicy
+ * @brief Shortest remaining time first, at the end of every quantum: the ready
+ * job with the least time remaining goes on the CPU. The time remaining of a job
+ * only changes on the CPU, so it is a stable key in the ready queue. Long jobs
+ * are not demoted, as they already come last.
+ */
+struct ShortestRemainingPolicy : RoundRobinPolicy {
+    static constexpr const char* NAME = "srtf";
+    
+    static constexpr bool ORDER_READY = true;
+    
+    static int order_ready(const SystemState& state, int job_id) {
+        return state.get_jobs().get_time_remaining(job_id);
+    }
+    
+    static constexpr bool DEMOTE_LONG_JOBS = false;
+};
+
+/**
+ * @struct ShortestJobPolicy
+ * @brief Shortest job first: the ready job with the least runtime goes on the
+ * CPU, and hold queue 2 is ordered by runtime too, first come, first served
+ * among equals. Long jobs are demoted and promoted as in RoundRobinPolicy.
+ */
+struct ShortestJobPolicy : RoundRobinPolicy {
+    static constexpr const char* NAME = "sjf";
+    
+    static int order_hold_2(const SystemState& state, int job_id) {
+        return state.get_jobs().get_runtime(job_id);
+    }
+    
+    static constexpr bool ORDER_READY = true;
+    
+    static int order_ready(const SystemState& state, int job_id) {
+        return state.get_jobs().get_runtime(job_id);
+    }
+};
+
+/**
+ * @struct MultilevelFeedbackPolicy
+ * @brief A multilevel feedback queue of LEVELS levels. A job starts at level 0, 
+ * where it runs for one quantum, and moves a level down for every time slice it 
+ * uses up; at level L it runs for 2^L quanta. The ready job of the highest level 
+ * (the lowest L) goes on the CPU, first come, first served within a level.
+ * 
+ * The level of a job follows from the CPU time it has used, so a job taken off 
+ * the CPU early by a device request only gets the rest of its time slice when it 
+ * is back. There is no priority boost. Long jobs are not demoted, as the lowest 
+ * level already holds them.
+ */
+struct MultilevelFeedbackPolicy : RoundRobinPolicy {
+    static constexpr const char* NAME = "mlfq";
+    static constexpr int LEVELS = 4;
+    
+    static constexpr bool ORDER_READY = true;
+    
+    static int order_ready(const SystemState& state, int job_id) {
+        return get_level(state, job_id);
+    }
+    
+    static int quantum(const SystemState& state, int job_id) {
+        int level = get_level(state, job_id);
+        if (level == LEVELS - 1) {
+            return state.get_quantum_length() << level;
+        }
+        return level_end(state, level) - used_time(state, job_id);
+    }
+    
+    static constexpr bool DEMOTE_LONG_JOBS = false;
+    
+private:
+    static int used_time(const SystemState& state, int job_id) {
+        const JobTable& jobs = state.get_jobs();
+        return jobs.get_runtime(job_id) - jobs.get_time_remaining(job_id);
+    }
+    
+    // Level L ends once a job has used 2^(L+1) - 1 quanta
+    static int level_end(const SystemState& state, int level) {
+        return state.get_quantum_length() * ((2 << level) - 1);
+    }
+    
+    static int get_level(const SystemState& state, int job_id) {
+        int used = used_time(state, job_id);
+        int level = 0;
+        while (level < LEVELS - 1 && used >= level_end(state, level)) {
+            level++;
+        }
+        return level;
+    }
+};
+
+#endif // _SCHEDULING_POLICIES_H_
@@ -0,0 +1,31 @@
+#include "ShortestJobQueue.h"
+
+using namespace std;
+
+ShortestJobQueue::ShortestJobQueue(Ties ties) 
+: m_entries(Order{ ties }), m_sequence(0) {
+}
+
+void ShortestJobQueue::insert(int job_id, int key) {
+    m_entries.insert(Entry{ key, m_sequence++, job_id });
+}
+
+ShortestJobQueue::const_iterator ShortestJobQueue::erase(const_iterator it) {
+    return m_entries.erase(it);
+}
+
+ShortestJobQueue::const_iterator ShortestJobQueue::begin() const {
+    return m_entries.begin();
+}
+
+ShortestJobQueue::const_iterator ShortestJobQueue::end() const {
+    return m_entries.end();
+}
+
+bool ShortestJobQueue::empty() const {
+    return m_entries.empty();
+}
+
+size_t ShortestJobQueue::size() const {
+    return m_entries.size();
+}
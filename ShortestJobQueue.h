@@ -0,0 +1,77 @@
+#ifndef _SHORTEST_JOB_QUEUE_H_
+#define _SHORTEST_JOB_QUEUE_H_
+
+#include <set>
+#include <cstddef>
+
+/**
+ * @class ShortestJobQueue
+ * @brief A queue of jobs ordered by a key, smallest first, such as the hold 
+ * queues and the ready queue ordered by the keys of the scheduling policy.
+ * 
+ * Jobs with the same key are ordered newest first or oldest first. Hold queue 1 
+ * takes the newest first, which is the order its linear insertion scan used to 
+ * produce (a new job went in front of the first job that was not shorter); the 
+ * other queues are first come, first served among equals. Insertion and removal 
+ * take O(log n).
+ */
+class ShortestJobQueue {
+public:
+    /**
+     * @enum Ties
+     * @brief The order of jobs with the same key.
+     */
+    enum class Ties {
+        NewestFirst,
+        OldestFirst,
+    };
+    
+    struct Entry {
+        int key;
+        unsigned long sequence; ///< Insertion order, to break key ties.
+        int job_id;
+    };
+    
+private:
+    struct Order {
+        Ties ties;
+        
+        bool operator() (const Entry& a, const Entry& b) const {
+            if (a.key != b.key) {
+                return a.key < b.key;
+            }
+            return (ties == Ties::NewestFirst) ? a.sequence > b.sequence 
+                                               : a.sequence < b.sequence;
+        }
+    };
+    
+public:
+    typedef std::set<Entry, Order>::const_iterator const_iterator;
+    
+    explicit ShortestJobQueue(Ties ties = Ties::NewestFirst);
+    
+    /**
+     * @brief Inserts a job in key order.
+     * @param job_id The job.
+     * @param key The key of the job, such as its runtime.
+     */
+    void insert(int job_id, int key);
+    
+    /**
+     * @brief Removes a job.
+     * @param it The position of the job.
+     * @return The position of the next job.
+     */
+    const_iterator erase(const_iterator it);
+    
+    const_iterator begin() const;
+    const_iterator end() const;
+    bool empty() const;
+    std::size_t size() const;
+    
+private:
+    std::set<Entry, Order> m_entries;
+    unsigned long m_sequence;
+};
+
+#endif // _SHORTEST_JOB_QUEUE_H_
@@ -0,0 +1,180 @@
+#include <iostream>
+#include <algorithm>
+#include <utility>
+
+#include "SnapshotWriter.h"
+#include "SystemState.h"
+
+using namespace std;
+
+SnapshotWriter::ConsoleBuffer::ConsoleBuffer(SnapshotWriter& writer, bool error)
+: m_writer(writer), m_error(error) {
+}
+
+SnapshotWriter::ConsoleBuffer::int_type SnapshotWriter::ConsoleBuffer::overflow(int_type c) {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        char ch = traits_type::to_char_type(c);
+        m_writer.collect(m_error, &ch, 1);
+    }
+    return traits_type::not_eof(c);
+}
+
+streamsize SnapshotWriter::ConsoleBuffer::xsputn(const char* s, streamsize count) {
+    m_writer.collect(m_error, s, count);
+    return count;
+}
+
+SnapshotWriter::SnapshotWriter(size_t capacity, DisplayOverflow overflow, bool delta)
+: m_capacity(capacity), m_overflow(overflow), m_output_console(*this, false), 
+  m_error_console(*this, true), m_output_out(nullptr), m_error_out(nullptr), 
+  m_console_text(), m_console_error(false), m_display_writer(delta), m_queue(), m_free_items(), 
+  m_stopping(false), m_finished(false), m_displays_queued(0), m_displays_dropped(0), 
+  m_queue_waits(0), m_queue_high_water(0) {
+    cout.flush();
+    m_output_out = cout.rdbuf(&m_output_console);
+    m_error_out = cerr.rdbuf(&m_error_console);
+    m_thread = thread(&SnapshotWriter::work, this);
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    finish();
+}
+
+/**
+ * Gets an item to fill once there is room in the queue. Items written by the
+ * writer thread are reused, so their storage is only allocated once.
+ * @param may_drop Whether to give up instead of waiting if the queue is full
+ * (with DisplayOverflow::Drop).
+ * @return The item, or null if it was given up.
+ */
+unique_ptr<SnapshotWriter::Item> SnapshotWriter::acquire_item(bool may_drop) {
+    unique_lock<mutex> lock(m_mutex);
+    if (m_queue.size() >= m_capacity) {
+        if (may_drop && m_overflow == DisplayOverflow::Drop) {
+            return nullptr;
+        }
+        m_queue_waits++;
+        m_queue_open.wait(lock, [this] { return m_queue.size() < m_capacity; });
+    }
+    if (m_free_items.empty()) {
+        return make_unique<Item>();
+    }
+    unique_ptr<Item> item = move(m_free_items.back());
+    m_free_items.pop_back();
+    return item;
+}
+
+void SnapshotWriter::queue_item(unique_ptr<Item> item) {
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_queue.push_back(move(item));
+        m_queue_high_water = max(m_queue_high_water, m_queue.size());
+    }
+    m_item_queued.notify_one();
+}
+
+/**
+ * Collects console output. Output of the other stream than the output collected 
+ * so far is queued first, so that the streams stay interleaved in order.
+ */
+void SnapshotWriter::collect(bool error, const char* s, size_t count) {
+    if (error != m_console_error && !m_console_text.empty()) {
+        queue_console();
+    }
+    m_console_error = error;
+    m_console_text.append(s, count);
+    if (m_console_text.size() >= CONSOLE_CHUNK_SIZE) {
+        queue_console();
+    }
+}
+
+/**
+ * Queues the console output collected so far without a display, so that it does
+ * not pile up between displays.
+ */
+void SnapshotWriter::queue_console() {
+    unique_ptr<Item> item = acquire_item(false);
+    // Swapping hands the storage of the item's text back for reuse
+    item->console.clear();
+    item->console.swap(m_console_text);
+    item->error = m_console_error;
+    item->has_display = false;
+    queue_item(move(item));
+}
+
+bool SnapshotWriter::submit(const SystemState& state, const string& filename,
+                            bool include_system_turnaround) {
+    if (m_console_error && !m_console_text.empty()) {
+        queue_console();
+    }
+    unique_ptr<Item> item = acquire_item(true);
+    if (item == nullptr) {
+        // The console output stays collected for the next item
+        m_displays_dropped++;
+        return false;
+    }
+    item->console.clear();
+    item->console.swap(m_console_text);
+    item->error = false;
+    item->has_display = true;
+    item->filename = filename;
+    state.capture_display(item->snapshot, include_system_turnaround);
+    queue_item(move(item));
+    m_displays_queued++;
+    return true;
+}
+
+void SnapshotWriter::finish() {
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    queue_console();
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_item_queued.notify_one();
+    m_thread.join();
+    cout.rdbuf(m_output_out);
+    cerr.rdbuf(m_error_out);
+}
+
+/**
+ * The writer thread: writes the queued items in order until finish() is called
+ * and the queue is empty.
+ */
+void SnapshotWriter::work() {
+    ostream output(m_output_out);
+    ostream error(m_error_out);
+    unique_lock<mutex> lock(m_mutex);
+    while (true) {
+        m_item_queued.wait(lock, [this] { return !m_queue.empty() || m_stopping; });
+        if (m_queue.empty()) {
+            break;
+        }
+        unique_ptr<Item> item = move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+        m_queue_open.notify_one();
+        
+        ostream& console = item->error ? error : output;
+        console.write(item->console.data(), item->console.size());
+        if (item->has_display) {
+            m_display_writer.write(item->snapshot, console, item->filename);
+        } else {
+            console.flush();
+        }
+        
+        lock.lock();
+        m_free_items.push_back(move(item));
+    }
+}
+
+void SnapshotWriter::print_stats(ostream& out) const {
+    out << "async_displays_queued: " << m_displays_queued << endl;
+    out << "async_displays_dropped: " << m_displays_dropped << endl;
+    out << "async_queue_waits: " << m_queue_waits << endl;
+    out << "async_queue_high_water: " << m_queue_high_water << endl;
+    m_display_writer.print_stats(out);
+}
@@ -0,0 +1,132 @@
+#ifndef _SNAPSHOT_WRITER_H_
+#define _SNAPSHOT_WRITER_H_
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <streambuf>
+#include <ostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+#include "DisplaySnapshot.h"
+#include "Options.h"
+
+class SystemState;
+
+/**
+ * @class SnapshotWriter
+ * @brief Renders and writes displays on a background thread.
+ *
+ * A display only copies the system state into a DisplaySnapshot and queues it;
+ * the writer thread renders the text and JSON output and writes them while the
+ * simulation goes on. So that the console output stays in order, the writer also
+ * takes over std::cout and std::cerr while it runs: everything printed by the
+ * simulation is collected and queued along with the displays, and the writer
+ * thread prints it in the same order.
+ *
+ * The queue holds at most a given number of items. When it is full, a display
+ * either waits for the writer thread or, with DisplayOverflow::Drop, is skipped
+ * (its "Display system status" line is still printed). Console output is never
+ * dropped. finish() writes everything still queued; it is called by the
+ * destructor at the latest.
+ */
+class SnapshotWriter {
+public:
+    /**
+     * @brief Starts the writer thread and redirects std::cout and std::cerr to it.
+     * @param capacity The maximum number of queued items, at least 1.
+     * @param overflow What a display does when the queue is full.
+     * @param delta Whether to write JSON files as deltas (see DisplayWriter).
+     */
+    SnapshotWriter(std::size_t capacity, DisplayOverflow overflow, bool delta);
+    ~SnapshotWriter();
+    
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator= (const SnapshotWriter&) = delete;
+    
+    /**
+     * @brief Queues a display of the current system state.
+     * @param state The system state.
+     * @param filename The name of the JSON file.
+     * @param include_system_turnaround Whether to show the system averages.
+     * @return False if the display was dropped because the queue was full.
+     */
+    bool submit(const SystemState& state, const std::string& filename,
+                bool include_system_turnaround);
+    
+    /**
+     * @brief Writes everything still queued, stops the writer thread and restores
+     * std::cout and std::cerr. Later calls do nothing.
+     */
+    void finish();
+    
+    void print_stats(std::ostream& out) const;
+
+private:
+    static constexpr std::size_t CONSOLE_CHUNK_SIZE = 64 << 10;
+    
+    /** Passes what is written to a console stream on to collect(). */
+    class ConsoleBuffer : public std::streambuf {
+    public:
+        ConsoleBuffer(SnapshotWriter& writer, bool error);
+    
+    protected:
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char* s, std::streamsize count) override;
+    
+    private:
+        SnapshotWriter& m_writer;
+        bool m_error;
+    };
+    
+    /**
+     * Console output of one stream, followed by a display (which is printed to
+     * std::cout) if has_display is set.
+     */
+    struct Item {
+        std::string console;
+        bool error;
+        bool has_display;
+        std::string filename;
+        DisplaySnapshot snapshot;
+    };
+    
+    std::size_t m_capacity;
+    DisplayOverflow m_overflow;
+    ConsoleBuffer m_output_console;
+    ConsoleBuffer m_error_console;
+    std::streambuf* m_output_out; ///< The buffer of std::cout before redirection.
+    std::streambuf* m_error_out;  ///< The buffer of std::cerr before redirection.
+    
+    // Console output collected on the simulation thread, all from one stream
+    std::string m_console_text;
+    bool m_console_error;
+    
+    std::mutex m_mutex;
+    std::condition_variable m_item_queued;
+    std::condition_variable m_queue_open;
+    DisplayWriter m_display_writer; ///< Only used by the writer thread.
+    std::deque<std::unique_ptr<Item>> m_queue;
+    std::vector<std::unique_ptr<Item>> m_free_items;
+    bool m_stopping;
+    bool m_finished;
+    std::thread m_thread;
+    
+    // Statistics, written by the simulation thread
+    unsigned long m_displays_queued;
+    unsigned long m_displays_dropped;
+    unsigned long m_queue_waits;
+    std::size_t m_queue_high_water;
+    
+    std::unique_ptr<Item> acquire_item(bool may_drop);
+    void queue_item(std::unique_ptr<Item> item);
+    void collect(bool error, const char* s, std::size_t count);
+    void queue_console();
+    void work();
+};
+
+#endif // _SNAPSHOT_WRITER_H_
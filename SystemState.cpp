@@ -5,18 +5,49 @@
 #include <iostream>
 #include <cmath>
 #include <numeric>
+#include <climits>
+#include <sys/resource.h>
 
 #include "SystemState.h"
+#include "SchedulingPolicies.h"
+#include "QuantumEndEvent.h"
+#include "SnapshotWriter.h"
+#include "Trace.h"
 
 using namespace std;
 
-SystemState::SystemState(int max_memory, int time_excess, int max_devices, int quantum_length, 
-                         int time) 
+SystemState::SystemState(int max_memory, int time_excess, const DeviceVector& max_devices, 
+                         int device_classes, int quantum_length, int time, 
+                         const Options& options) 
 : m_max_memory(max_memory), m_time_excess(time_excess), m_max_devices(max_devices), 
-  m_quantum_length(quantum_length), m_allocated_memory(0),
-  m_allocated_devices(0), m_time(time), m_jobs(), m_event_queue(), 
-  m_hold_queue_1(), m_hold_queue_2(), m_ready_queue(), m_wait_queue(), 
-  m_cpu(NoJob), m_cpu_quantum_remaining(0), m_complete_queue() {
+  m_device_classes(device_classes), m_quantum_length(quantum_length), 
+  m_allocated_memory(0), m_allocated_devices(), m_time(time), m_jobs(), m_event_pool(), 
+  m_engine(options.engine), m_event_queue(options.event_order), 
+  m_record_queue(options.event_order), m_record_devices(), m_events_processed(0), m_event_loop_time(0), 
+  m_display_snapshot(), m_display_writer(options.delta_display), m_snapshot_writer(nullptr), m_displays(0), 
+  m_display_jobs(0), m_display_time(0), 
+  m_cpu_timers(time), m_cpu_timer(TimingWheel::NoTimer), m_dispatch_generation(0),
+  m_fire_stale_timers(options.fire_stale_timers), m_stale_timers_cancelled(0),
+  m_stale_timer_firings(0), m_wait_dirty(false), m_hold_dirty(false), 
+  m_update_passes(0), m_update_passes_skipped(0), m_wait_scans(0), 
+  m_wait_scans_skipped(0), m_bankers_checks(0), m_negative_allocation(false), 
+  m_need_index(device_classes), m_bankers_inclusive(options.bankers_inclusive), 
+  m_check_bankers(options.check_bankers), 
+  m_hold_queue_1(), m_hold_queue_2(ShortestJobQueue::Ties::OldestFirst), m_ready_queue(), 
+  m_ready_order(ShortestJobQueue::Ties::OldestFirst), m_wait_queue(), 
+  m_cpu(NoJob), m_cpu_quantum_remaining(0), m_policy(options.policy), m_complete_queue(), 
+  m_streaming(options.stream), m_retired_jobs(0), m_retired_turnaround_sum(0), 
+  m_retired_weighted_turnaround_sum(0), m_retired_max_turnaround(0), 
+  m_live_jobs_high_water(0), m_turnarounds(), m_weighted_turnarounds(), 
+  m_turnaround_stats(options.turnaround_stats), m_latencies(), 
+  m_latency_stats(options.latency_stats), m_hold_1_memory(), m_hold_2_memory(), m_hold_scans(0), 
+  m_hold_scans_skipped(0) {
+}
+
+SystemState::~SystemState() {
+    while (!m_event_queue.empty()) {
+        release_event(pop_next_event());
+    }
 }
 
 int SystemState::get_max_memory() const {
@@ -27,15 +58,19 @@ int SystemState::get_time_excess() const{
     return m_time_excess;
 }
 
-int SystemState::get_max_devices() const {
+const DeviceVector& SystemState::get_max_devices() const {
     return m_max_devices;
 }
 
+int SystemState::get_device_classes() const {
+    return m_device_classes;
+}
+
 int SystemState::get_allocated_memory() const {
     return m_allocated_memory;
 }
 
-int SystemState::get_allocated_devices() const {
+const DeviceVector& SystemState::get_allocated_devices() const {
     return m_allocated_devices;
 }
 
@@ -43,22 +78,44 @@ int SystemState::get_available_memory() const {
     return get_max_memory() - get_allocated_memory();
 }
 
-int SystemState::get_available_devices() const {
+DeviceVector SystemState::get_available_devices() const {
     return get_max_devices() - get_allocated_devices();
 }
 
 void SystemState::allocate_requested_devices(int job_id) {
-    m_allocated_devices += m_jobs.at(job_id).get_requested_devices();
-    m_jobs.at(job_id).allocate_requested_devices();
+    m_allocated_devices += m_jobs.get_requested_devices(job_id);
+    m_wait_dirty = true;
+    m_jobs.allocate_requested_devices(job_id);
+    m_need_index.update(job_id, 
+                        m_jobs.get_max_devices(job_id) - m_jobs.get_allocated_devices(job_id),
+                        m_jobs.get_allocated_devices(job_id));
+    if (m_jobs.get_allocated_devices(job_id).any_negative()) {
+        m_negative_allocation = true;
+    }
 }
 
-void SystemState::cpu_request_devices(int devices) {
-    m_jobs.at(m_cpu).set_requested_devices(devices);
+void SystemState::cpu_request_devices(const DeviceVector& devices) {
+    if (m_cpu == NoJob) {
+        throw runtime_error("Error: No job on the CPU.");
+    }
+    m_jobs.set_requested_devices(m_cpu, devices);
 }
 
-void SystemState::cpu_release_devices(int devices) {
-    m_jobs.at(m_cpu).release_devices(devices);
+void SystemState::cpu_release_devices(const DeviceVector& devices) {
+    if (m_cpu == NoJob) {
+        throw runtime_error("Error: No job on the CPU.");
+    }
+    // devices may be the job's own allocation, so it is read before the job's 
+    // allocation changes
     m_allocated_devices -= devices;
+    m_jobs.release_devices(m_cpu, devices);
+    m_need_index.update(m_cpu, 
+                        m_jobs.get_max_devices(m_cpu) - m_jobs.get_allocated_devices(m_cpu),
+                        m_jobs.get_allocated_devices(m_cpu));
+    m_wait_dirty = true;
+    if (m_jobs.get_allocated_devices(m_cpu).any_negative()) {
+        m_negative_allocation = true;
+    }
 }
 
 void SystemState::allocate_memory(int memory) {
@@ -67,6 +124,7 @@ void SystemState::allocate_memory(int memory) {
 
 void SystemState::release_memory(int memory) {
     m_allocated_memory -= memory;
+    m_hold_dirty = true;
 }
 
 int SystemState::get_quantum_length() const {
@@ -83,12 +141,13 @@ int SystemState::get_time() const {
 }
 
 void SystemState::set_time(int time) {
-    
-    cout << "Time set to " << time << ", was " << m_time << endl;
+
+    TRACE(TraceLevel::Time, "Time set to " << time << ", was " << m_time);
     int delta = time - m_time;
     m_time = time;
+    m_cpu_timers.advance(time);
     if (m_cpu != NoJob) {
-        m_jobs.at(m_cpu).step_time(delta);
+        m_jobs.step_time(m_cpu, delta);
         m_cpu_quantum_remaining -= delta;
     }
 }
@@ -98,59 +157,251 @@ void SystemState::end_quantum() {
     m_cpu_quantum_remaining = 0;
 }
 
+void SystemState::release_event(Event* e) {
+    m_event_pool.release(e);
+}
+
 void SystemState::schedule_event(Event* e) {
-    deque<Event*>::iterator it = m_event_queue.begin();
-    while (it != m_event_queue.end() && **it < *e) {
-        it++;
+    m_event_queue.push(e);
+}
+
+Event* SystemState::get_next_event() const {
+    return m_event_queue.top();
+}
+
+Event* SystemState::pop_next_event() {
+    return m_event_queue.pop();
+}
+
+void SystemState::schedule_arrival(int time, const Job& job) {
+    if (m_engine == EventEngine::Variant) {
+        m_record_queue.push(EventRecord(time, JobArrivalRecord{ 
+            job.get_number(), job.get_max_memory(), m_record_devices.store(job.get_max_devices()), 
+            job.get_runtime(), job.get_priority() }));
+    } else {
+        schedule_event(new_event<JobArrivalEvent>(time, job));
+    }
+}
+
+void SystemState::schedule_device_request(int time, int job_number, 
+                                          const DeviceVector& requested_devices) {
+    if (m_engine == EventEngine::Variant) {
+        m_record_queue.push(EventRecord(
+            time, DeviceRequestRecord{ job_number, m_record_devices.store(requested_devices) }));
+    } else {
+        schedule_event(new_event<DeviceRequestEvent>(time, job_number, 
+                                                     requested_devices));
+    }
+}
+
+void SystemState::schedule_device_release(int time, int job_number, 
+                                          const DeviceVector& released_devices) {
+    if (m_engine == EventEngine::Variant) {
+        m_record_queue.push(EventRecord(
+            time, DeviceReleaseRecord{ job_number, m_record_devices.store(released_devices) }));
+    } else {
+        schedule_event(new_event<DeviceReleaseEvent>(time, job_number, 
+                                                     released_devices));
+    }
+}
+
+// The filename is referenced, not copied, by the variant engine, so it must 
+// outlive the event
+void SystemState::schedule_display(int time, const string& filename) {
+    if (m_engine == EventEngine::Variant) {
+        m_record_queue.push(EventRecord(time, DisplayRecord{ &filename }));
+    } else {
+        schedule_event(new_event<DisplayEvent>(time, filename));
     }
-    m_event_queue.insert(it, e);
 }
 
 bool SystemState::has_next_event() const {
-    return !m_event_queue.empty();
+    if (!m_cpu_timers.empty()) {
+        return true;
+    } else if (m_engine == EventEngine::Variant) {
+        return !m_record_queue.empty();
+    } else {
+        return !m_event_queue.empty();
+    }
 }
 
-Event* SystemState::get_next_event() const {
-    return m_event_queue.front();
+int SystemState::get_next_event_time() const {
+    // Input files may run past END_TIME, so the CPU timers must be looked at 
+    // even when there is no other event before it
+    int time = INT_MAX;
+    if (m_engine == EventEngine::Variant && !m_record_queue.empty()) {
+        time = m_record_queue.top().get_time();
+    } else if (m_engine == EventEngine::Virtual && !m_event_queue.empty()) {
+        time = m_event_queue.top()->get_time();
+    } else if (m_cpu_timers.empty()) {
+        throw runtime_error("Error: No pending events.");
+    }
+    if (!m_cpu_timers.empty()) {
+        time = min(time, m_cpu_timers.next_expiry());
+    }
+    return time;
 }
 
-Event* SystemState::pop_next_event() {
-    Event* e = m_event_queue.front();
-    m_event_queue.pop_front();
-    return e;
+/**
+ * Processes the next event or CPU timer. A timer expiring at the same time as 
+ * a queued event fires first, since quantum ends are internal events.
+ */
+void SystemState::process_next_event() {
+    bool queue_empty = (m_engine == EventEngine::Variant) ? m_record_queue.empty() 
+                                                          : m_event_queue.empty();
+    if (!m_cpu_timers.empty() 
+        && (queue_empty || m_cpu_timers.next_expiry() <= get_next_event_time())) {
+        TimingWheel::Timer timer = m_cpu_timers.pop();
+        if (timer.generation == m_dispatch_generation) {
+            m_cpu_timer = TimingWheel::NoTimer;
+        } else {
+            m_stale_timer_firings++;
+        }
+        handle_quantum_end(*this, timer.expiry);
+    } else if (m_engine == EventEngine::Variant) {
+        EventRecord r = m_record_queue.pop();
+        r.process(*this);
+    } else {
+        Event* e = pop_next_event();
+        e->process(*this);
+        release_event(e);
+    }
+    m_events_processed++;
+}
+
+void SystemState::record_event_loop_time(chrono::steady_clock::duration elapsed) {
+    m_event_loop_time += elapsed;
+}
+
+/**
+ * Records the time taken by a display, which renders every job in the job table.
+ */
+void SystemState::record_display_time(chrono::steady_clock::duration elapsed) {
+    m_displays++;
+    m_display_jobs += m_jobs.size();
+    m_display_time += elapsed;
+}
+
+DisplaySnapshot& SystemState::get_display_snapshot() {
+    return m_display_snapshot;
+}
+
+RecordDeviceTable& SystemState::get_record_devices() {
+    return m_record_devices;
+}
+
+DisplayWriter& SystemState::get_display_writer() {
+    return m_display_writer;
+}
+
+void SystemState::set_snapshot_writer(SnapshotWriter* writer) {
+    m_snapshot_writer = writer;
+}
+
+SnapshotWriter* SystemState::get_snapshot_writer() const {
+    return m_snapshot_writer;
 }
 
-void SystemState::add_job(const Job& job) {
-    m_jobs.insert({{ job.get_number(), job }});
+/**
+ * Adds a job to the job table. If a job with the same number is already in the 
+ * system, that job is kept.
+ * @return The slot that identifies the job in the queues.
+ */
+int SystemState::add_job(const Job& job) {
+    int job_id = m_jobs.add(job);
+    m_live_jobs_high_water = max(m_live_jobs_high_water, m_jobs.size());
+    return job_id;
+}
+
+/**
+ * Calls a function with a value of the type of the scheduling policy set in the 
+ * options (see SchedulingPolicies.h), so that the policy's decisions are inlined.
+ * @tparam Function A callable that takes any policy type, such as a generic lambda.
+ */
+template <typename Function>
+void SystemState::with_policy(Function function) const {
+    switch (m_policy) {
+        case SchedulingPolicy::Priority:
+            function(PriorityPolicy());
+            break;
+        case SchedulingPolicy::ShortestRemaining:
+            function(ShortestRemainingPolicy());
+            break;
+        case SchedulingPolicy::ShortestJob:
+            function(ShortestJobPolicy());
+            break;
+        case SchedulingPolicy::Multilevel:
+            function(MultilevelFeedbackPolicy());
+            break;
+        default:
+            function(RoundRobinPolicy());
+            break;
+    }
 }
 
 void SystemState::schedule_job(JobQueue queue, int job_id) {
+    // Jobs that hold devices entering or leaving the active set can change the 
+    // outcome of the banker's algorithm for waiting jobs
+    if (queue == JobQueue::LongQ || queue == JobQueue::Complete 
+        || m_jobs.get_allocated_devices(job_id).any_positive()) {
+        m_wait_dirty = true;
+    }
     if (queue == JobQueue::Hold1) {
-        deque<int>::iterator it = m_hold_queue_1.begin();
-        while (it != m_hold_queue_1.end() 
-               && m_jobs.at(*it).get_runtime() < m_jobs.at(job_id).get_runtime()) {
-            it++;
-        }
-        m_hold_queue_1.insert(it, job_id);
-        cout << "Job " << job_id << " placed in hold queue 1" << endl;
+        with_policy([&](auto policy) {
+            m_hold_queue_1.insert(job_id, decltype(policy)::order_hold_1(*this, job_id));
+        });
+        enter_queue(queue, job_id);
+        m_hold_1_memory.insert(m_jobs.get_max_memory(job_id));
+        TRACE(TraceLevel::Decisions, "Job " << m_jobs.get_number(job_id) << " placed in hold queue 1");
+        TRACE_DECISION(m_time, Trace::Decision::Hold1, m_jobs.get_number(job_id));
     } else if (queue == JobQueue::Hold2) {
-        m_hold_queue_2.push_back(job_id);
-        cout << "Job " << job_id << " placed in hold queue 2" << endl;
+        with_policy([&](auto policy) {
+            m_hold_queue_2.insert(job_id, decltype(policy)::order_hold_2(*this, job_id));
+        });
+        enter_queue(queue, job_id);
+        m_hold_2_memory.insert(m_jobs.get_max_memory(job_id));
+        TRACE(TraceLevel::Decisions, "Job " << m_jobs.get_number(job_id) << " placed in hold queue 2");
+        TRACE_DECISION(m_time, Trace::Decision::Hold2, m_jobs.get_number(job_id));
     } else if (queue == JobQueue::LongQ) {
         m_long_queue.push_back(job_id);
-        cout << "Job " << job_id << " placed in long queue" << endl;
+        enter_queue(queue, job_id);
+        TRACE(TraceLevel::Decisions, "Job " << m_jobs.get_number(job_id) << " placed in long queue");
+        TRACE_DECISION(m_time, Trace::Decision::LongQ, m_jobs.get_number(job_id));
         } else if (queue == JobQueue::Ready) {
-        m_ready_queue.push_back(job_id);
-        cout << "Job " << job_id << " placed in ready queue" << endl;
+        with_policy([&](auto policy) {
+            typedef decltype(policy) Policy;
+            if constexpr (Policy::ORDER_READY) {
+                m_ready_order.insert(job_id, Policy::order_ready(*this, job_id));
+            } else {
+                m_ready_queue.push_back(job_id);
+            }
+        });
+        enter_queue(queue, job_id);
+        m_need_index.add(job_id, 
+                         m_jobs.get_max_devices(job_id) - m_jobs.get_allocated_devices(job_id),
+                         m_jobs.get_allocated_devices(job_id));
+        TRACE(TraceLevel::Decisions, "Job " << m_jobs.get_number(job_id) << " placed in ready queue");
+        TRACE_DECISION(m_time, Trace::Decision::Ready, m_jobs.get_number(job_id));
     } else if (queue == JobQueue::Wait) {
-        cout << "Job " << job_id << " placed in wait queue" << endl;
+        TRACE(TraceLevel::Decisions, "Job " << m_jobs.get_number(job_id) << " placed in wait queue");
+        TRACE_DECISION(m_time, Trace::Decision::Wait, m_jobs.get_number(job_id));
         m_wait_queue.push_back(job_id);
+        enter_queue(queue, job_id);
+        m_need_index.add(job_id, 
+                         m_jobs.get_max_devices(job_id) - m_jobs.get_allocated_devices(job_id),
+                         m_jobs.get_allocated_devices(job_id));
     } else if (queue == JobQueue::Complete) {
-        m_complete_queue.push_back(job_id);
-        cout << "Job " << job_id << " placed in complete queue" << endl;
+        TRACE(TraceLevel::Decisions, "Job " << m_jobs.get_number(job_id) << " placed in complete queue");
+        TRACE_DECISION(m_time, Trace::Decision::Complete, m_jobs.get_number(job_id));
+        if (m_streaming && !job_is_queued(job_id)) {
+            retire_job(job_id);
+        } else {
+            m_complete_queue.push_back(job_id);
+            enter_queue(queue, job_id);
+        }
     }
 }
-    
+
 bool SystemState::has_next_job(JobQueue queue) {
     return !get_queue(queue).empty();
 }
@@ -162,13 +413,40 @@ int SystemState::get_next_job(JobQueue queue) {
 int SystemState::pop_next_job(JobQueue queue) {
     int job_id = get_queue(queue).front();
     get_queue(queue).pop_front();
+    leave_queue(queue, job_id);
     return job_id;
 }
 
+void SystemState::enter_queue(JobQueue queue, int job_id) {
+    m_jobs.enter_queue(job_id, static_cast<int>(queue), m_time);
+}
+
+/**
+ * Takes a job out of a queue's entry count and records how long it waited in the 
+ * queues whose latencies are kept.
+ */
+void SystemState::leave_queue(JobQueue queue, int job_id) {
+    m_jobs.leave_queue(job_id, static_cast<int>(queue));
+    int waited = m_time - m_jobs.get_queue_entry_time(job_id, static_cast<int>(queue));
+    switch (queue) {
+        case JobQueue::Hold1: get_latency(DisplaySnapshot::Latency::Hold1).record(waited); break;
+        case JobQueue::Hold2: get_latency(DisplaySnapshot::Latency::Hold2).record(waited); break;
+        case JobQueue::Ready: get_latency(DisplaySnapshot::Latency::Ready).record(waited); break;
+        case JobQueue::Wait: get_latency(DisplaySnapshot::Latency::Wait).record(waited); break;
+        default: break;
+    }
+}
+
+LatencyHistogram& SystemState::get_latency(DisplaySnapshot::Latency latency) {
+    return m_latencies[static_cast<int>(latency)];
+}
+
+bool SystemState::is_in_queue(JobQueue queue, int job_id) const {
+    return m_jobs.is_in_queue(job_id, static_cast<int>(queue));
+}
+
 deque<int>& SystemState::get_queue(JobQueue queue) {
     switch (queue) {
-        case JobQueue::Hold1: return m_hold_queue_1;
-        case JobQueue::Hold2: return m_hold_queue_2;
         case JobQueue::LongQ: return m_long_queue;
         case JobQueue::Ready: return m_ready_queue;
         case JobQueue::Wait: return m_wait_queue;
@@ -177,66 +455,188 @@ deque<int>& SystemState::get_queue(JobQueue queue) {
     }
 }
 
+bool SystemState::has_ready_jobs() const {
+    return !m_ready_queue.empty() || !m_ready_order.empty();
+}
+
+/**
+ * Checks if a job is still in a queue other than the complete queue. A job that 
+ * completes can still be in the long queue, and is then completed again later.
+ */
+bool SystemState::job_is_queued(int job_id) const {
+    // The complete queue comes last in JobQueue order
+    int queue = m_jobs.get_first_queue(job_id);
+    return queue != JobTable::NoQueue && queue != static_cast<int>(JobQueue::Complete);
+}
+
+/**
+ * Folds a completed job into the retired job totals and removes it from the job 
+ * table and the complete queue.
+ */
+void SystemState::retire_job(int job_id) {
+    int turnaround = m_jobs.get_completion_time(job_id) - m_jobs.get_arrival_time(job_id);
+    m_retired_jobs++;
+    m_retired_turnaround_sum += turnaround;
+    m_retired_weighted_turnaround_sum += turnaround / (double) m_jobs.get_runtime(job_id);
+    m_retired_max_turnaround = max(m_retired_max_turnaround, turnaround);
+    
+    m_complete_queue.erase(remove(m_complete_queue.begin(), m_complete_queue.end(), job_id), 
+                           m_complete_queue.end());
+    m_jobs.remove(job_id);
+}
+
+/**
+ * Sets the completion time of a job and adds its turnarounds to the running 
+ * statistics. A job completed again (see job_is_queued()) is only counted once, 
+ * with its last turnaround.
+ */
+void SystemState::record_completion(int job_id, int time) {
+    double runtime = m_jobs.get_runtime(job_id);
+    if (is_in_queue(JobQueue::Complete, job_id)) {
+        int turnaround = m_jobs.get_completion_time(job_id) - m_jobs.get_arrival_time(job_id);
+        m_turnarounds.remove(turnaround);
+        m_weighted_turnarounds.remove(turnaround / runtime);
+        get_latency(DisplaySnapshot::Latency::Turnaround).remove(turnaround);
+    }
+    m_jobs.set_completion_time(job_id, time);
+    int turnaround = time - m_jobs.get_arrival_time(job_id);
+    m_turnarounds.add(turnaround);
+    m_weighted_turnarounds.add(turnaround / runtime);
+    get_latency(DisplaySnapshot::Latency::Turnaround).record(turnaround);
+}
+
+/**
+ * Puts a job on the CPU (or empties it, if job_id is NoJob) and arms the quantum 
+ * timer of the new dispatch. A timer still armed at this point belongs to a 
+ * job that left the CPU early, so it is cancelled rather than left to fire.
+ */
 void SystemState::cpu_set_job(int job_id) {
+    if (m_cpu_timer != TimingWheel::NoTimer) {
+        if (!m_fire_stale_timers) {
+            m_cpu_timers.cancel(m_cpu_timer);
+            m_stale_timers_cancelled++;
+        }
+        m_cpu_timer = TimingWheel::NoTimer;
+    }
+    // A job put on the CPU keeps the active set entry it had in the ready queue
+    if (job_id == NoJob && m_cpu != NoJob) {
+        m_need_index.remove(m_cpu);
+    }
     m_cpu = job_id;
     if (job_id == NoJob){
         m_cpu_quantum_remaining = 0;
     } else {
-        m_cpu_quantum_remaining = min(m_jobs.at(job_id).get_time_remaining(), 
-                                      get_quantum_length());
-        QuantumEndEvent* e = new QuantumEndEvent(get_time() 
-                                                 + m_cpu_quantum_remaining);
-        schedule_event(e);
+        int quantum = 0;
+        with_policy([&](auto policy) {
+            quantum = decltype(policy)::quantum(*this, job_id);
+        });
+        m_cpu_quantum_remaining = min(m_jobs.get_time_remaining(job_id), quantum);
+        if (m_jobs.get_start_time(job_id) == JobTable::NotStarted) {
+            m_jobs.set_start_time(job_id, m_time);
+            get_latency(DisplaySnapshot::Latency::Response)
+                .record(m_time - m_jobs.get_arrival_time(job_id));
+        }
+        m_dispatch_generation++;
+        m_cpu_timer = m_cpu_timers.arm(get_time() + m_cpu_quantum_remaining, 
+                                       m_dispatch_generation);
     }
 }
 
+const JobTable& SystemState::get_jobs() const {
+    return m_jobs;
+}
+
 int SystemState::cpu_get_job() const {
     return m_cpu;
 }
 
+int SystemState::cpu_get_job_number() const {
+    return (m_cpu == NoJob) ? NoJob : m_jobs.get_number(m_cpu);
+}
+
+/**
+ * Checks if the device request of an active job can be granted safely. With no 
+ * negative allocations (see DeviceNeedIndex), the safety algorithm runs over the 
+ * jobs sorted by need; otherwise the textbook algorithm is used.
+ */
 bool SystemState::bankers_valid(int requester) const {
+    m_bankers_checks++;
+    const DeviceVector& request = m_jobs.get_requested_devices(requester);
+    if (m_negative_allocation || request.any_negative()) {
+        return bankers_valid_textbook(requester);
+    }
+    
+    // Resource request algorithm
+    if (request.any_greater(m_jobs.get_max_devices(requester) 
+                            - m_jobs.get_allocated_devices(requester))) {
+        throw runtime_error("Error: process has exceeded its maximum claim.");
+    }
+    DeviceVector available = get_available_devices();
+    bool safe = !request.any_greater(available) 
+                && m_need_index.is_safe(requester, request, available, m_bankers_inclusive);
+    if (m_check_bankers && safe != bankers_valid_textbook(requester)) {
+        throw runtime_error("Error: Banker's algorithm results disagree.");
+    }
+    return safe;
+}
+
+/**
+ * The textbook banker's algorithm, which restarts its search for a job that can 
+ * finish after every job it finishes.
+ */
+bool SystemState::bankers_valid_textbook(int requester) const {
     // Collect jobs
-    vector<Job> active_jobs;
+    vector<int> active_jobs;
     if (m_cpu != NoJob) {
-        active_jobs.push_back(m_jobs.at(m_cpu));
+        active_jobs.push_back(m_cpu);
     }
     for (int j : m_ready_queue) {
-        active_jobs.push_back(m_jobs.at(j));
+        active_jobs.push_back(j);
+    }
+    // With negative allocations the result depends on the order of the jobs, 
+    // which is the order they entered the ready queue under every policy
+    vector<ShortestJobQueue::Entry> ready_entries(m_ready_order.begin(), m_ready_order.end());
+    sort(ready_entries.begin(), ready_entries.end(), 
+         [](const ShortestJobQueue::Entry& a, const ShortestJobQueue::Entry& b) {
+             return a.sequence < b.sequence;
+         });
+    for (const ShortestJobQueue::Entry& entry : ready_entries) {
+        active_jobs.push_back(entry.job_id);
     }
     for (int j : m_wait_queue) {
-        active_jobs.push_back(m_jobs.at(j));
+        active_jobs.push_back(j);
     }
     
     // Setup
-    int Available = get_available_devices();
-    vector<int> Max;
-    for (const Job& j : active_jobs) {
-        Max.push_back(j.get_max_devices());
+    DeviceVector Available = get_available_devices();
+    vector<DeviceVector> Max;
+    for (int j : active_jobs) {
+        Max.push_back(m_jobs.get_max_devices(j));
     }
-    vector<int> Allocation;
-    for (const Job& j : active_jobs) {
-        Allocation.push_back(j.get_allocated_devices());
+    vector<DeviceVector> Allocation;
+    for (int j : active_jobs) {
+        Allocation.push_back(m_jobs.get_allocated_devices(j));
     }
-    vector<int> Need;
+    vector<DeviceVector> Need;
     for (unsigned int i = 0; i < active_jobs.size(); i++) {
         Need.push_back(Max[i] - Allocation[i]);
     }
     int requester_i;
     for (unsigned int i = 0; i < active_jobs.size(); i++) {
-        if (active_jobs[i].get_number() == requester) {
+        if (active_jobs[i] == requester) {
             requester_i = i;
             break;
         }
     }
-    int Request = active_jobs[requester_i].get_requested_devices();
+    DeviceVector Request = m_jobs.get_requested_devices(active_jobs[requester_i]);
     
     // Resource request algorithm
     // Step 1
-    if (Request > Need[requester_i]) {
+    if (Request.any_greater(Need[requester_i])) {
         throw runtime_error("Error: process has exceeded its maximum claim.");
     }
     // Step 2
-    if (Request > Available) {
+    if (Request.any_greater(Available)) {
         return false;
     }
     // Step 3: pretend to allocate resources
@@ -246,7 +646,8 @@ bool SystemState::bankers_valid(int requester) const {
     
     // Safety algorithm
     // Step 1
-    int Work = Available;
+    DeviceVector Work = Available;
+    unsigned int classes_mask = (1u << m_device_classes) - 1;
     vector<bool> Finish;
     for (unsigned int i = 0; i < active_jobs.size(); i++) {
         Finish.push_back(false);
@@ -254,7 +655,8 @@ bool SystemState::bankers_valid(int requester) const {
     // Step 2
     search:
     for (unsigned int i = 0; i < active_jobs.size(); i++) {
-        if (Finish[i] == false && Need[i] < Work) {
+        if (Finish[i] == false 
+            && Need[i].fits(Work, classes_mask, m_bankers_inclusive)) {
             // Step 3
             Work += Allocation[i];
             Finish[i] = true;
@@ -270,17 +672,31 @@ bool SystemState::bankers_valid(int requester) const {
     return true;
 }
 
+/**
+ * Updates the job queues based on the current system state, with the decisions 
+ * of the scheduling policy set in the options.
+ */
+void SystemState::update_queues() {
+    with_policy([this](auto policy) {
+        update_queues_with<decltype(policy)>();
+    });
+}
+
 /**
  * Updates the job queues based on the current system state.
  * This function is responsible for moving jobs between different queues
  * based on their completion status, device requests, and memory requirements.
  * It also assigns jobs to the CPU if there is no job currently running.
+ * 
+ * @tparam Policy The scheduling policy (see SchedulingPolicies.h).
  */
-void SystemState::update_queues() {
-    //cout << "Job " << m_cpu << m_jobs.at(m_cpu).get_runtime() - m_jobs.at(m_cpu).get_time_remaining() << " Accrued Time" << endl;
+template <typename Policy>
+void SystemState::update_queues_with() {
+    m_update_passes++;
+    //cout << "Job " << m_cpu << m_jobs.get_runtime(m_cpu) - m_jobs.get_time_remaining(m_cpu) << " Accrued Time" << endl;
     
-    /*if (m_cpu != NoJob && (m_jobs.at(m_cpu).get_runtime() - m_jobs.at(m_cpu).get_time_remaining()) >= get_time_excess()){
-        cout << "Job " << m_cpu << " is a long job, so move to long queue, while holding on to memory and devices" << endl;
+    /*if (m_cpu != NoJob && (m_jobs.get_runtime(m_cpu) - m_jobs.get_time_remaining(m_cpu)) >= get_time_excess()){
+        cout << "Job " << m_jobs.get_number(m_cpu) << " is a long job, so move to long queue, while holding on to memory and devices" << endl;
         schedule_job(JobQueue::LongQ, m_cpu);
     }*/
     // Push job off cpu into ready queue (or wait queue if there is an active 
@@ -289,27 +705,32 @@ void SystemState::update_queues() {
     if (m_cpu != NoJob && m_cpu_quantum_remaining == 0) {
         // The job on the CPU is done (either because quantum ended or device 
         // request/release)
-        if (m_jobs.at(m_cpu).get_time_remaining() == 0) {
+        if (m_jobs.get_time_remaining(m_cpu) == 0) {
             // Job is complete, so release memory and devices
-            cout << "Job " << m_cpu << " is complete, so release memory and devices" << endl;
-            release_memory(m_jobs.at(m_cpu).get_max_memory());
-            cpu_release_devices(m_jobs.at(m_cpu).get_allocated_devices());
-            m_jobs.at(m_cpu).set_completion_time(m_time);
+            TRACE(TraceLevel::Decisions, "Job " << m_jobs.get_number(m_cpu) 
+                  << " is complete, so release memory and devices");
+            TRACE_DECISION(m_time, Trace::Decision::Finished, m_jobs.get_number(m_cpu));
+            release_memory(m_jobs.get_max_memory(m_cpu));
+            cpu_release_devices(m_jobs.get_allocated_devices(m_cpu));
+            record_completion(m_cpu, m_time);
             schedule_job(JobQueue::Complete, m_cpu);
         } else {
             // Job is not yet complete
-            if (m_jobs.at(m_cpu).get_runtime() - m_jobs.at(m_cpu).get_time_remaining() >= get_time_excess()) {
+            if (Policy::DEMOTE_LONG_JOBS 
+                && m_jobs.get_runtime(m_cpu) - m_jobs.get_time_remaining(m_cpu) >= get_time_excess()) {
                 if (!m_can_move) {
-                    cout << "Job " << m_cpu << " is a long job, so move to long queue." << endl;
+                    TRACE(TraceLevel::Decisions, "Job " << m_jobs.get_number(m_cpu) 
+                          << " is a long job, so move to long queue.");
+                    TRACE_DECISION(m_time, Trace::Decision::LongJob, m_jobs.get_number(m_cpu));
                     schedule_job(JobQueue::LongQ, m_cpu);
                 }
                 else if (m_can_move) {
                     schedule_job(JobQueue::Ready, m_cpu);
                 }
             }
-            if (m_jobs.at(m_cpu).get_requested_devices() > 0) { 
+            if (m_jobs.get_requested_devices(m_cpu).any_positive()) { 
                 // A device request was made
-                if (bankers_valid(m_cpu)) { 
+                if (Policy::grant_devices(*this, m_cpu)) { 
                     // The request can be granted immediately
                     allocate_requested_devices(m_cpu);
                     schedule_job(JobQueue::Ready, m_cpu);
@@ -325,26 +746,46 @@ void SystemState::update_queues() {
         cpu_set_job(NoJob);
     }
     
-    // Move all jobs in wait queue that now pass banker's check to ready queue
-    for (deque<int>::iterator it = m_wait_queue.begin();
-         it != m_wait_queue.end();) {
-        int job_id = *it;
-        if (bankers_valid(job_id)) {
-            it = m_wait_queue.erase(it);
-            allocate_requested_devices(job_id);
-            schedule_job(JobQueue::Ready, job_id);
-        } else {
-            it++;
+    // Move all jobs in wait queue that now pass banker's check to ready queue. 
+    // Every waiting job failed the check when the queue was last evaluated, so 
+    // this is only needed if devices changed hands or a job holding devices 
+    // entered or left the active set since then (m_wait_dirty). A job joining 
+    // the active set without devices can only make the state less safe. This 
+    // does not hold once a job has released more devices than it held, since 
+    // the safety check then depends on the order of the active jobs.
+    if (m_wait_dirty || m_negative_allocation) {
+        m_wait_dirty = false;
+        m_wait_scans++;
+        for (deque<int>::iterator it = m_wait_queue.begin();
+             it != m_wait_queue.end();) {
+            int job_id = *it;
+            if (Policy::grant_devices(*this, job_id)) {
+                it = m_wait_queue.erase(it);
+                leave_queue(JobQueue::Wait, job_id);
+                m_need_index.remove(job_id);
+                allocate_requested_devices(job_id);
+                schedule_job(JobQueue::Ready, job_id);
+            } else {
+                it++;
+            }
         }
+    } else if (!m_wait_queue.empty()) {
+        m_wait_scans_skipped++;
     }
     
-    // Move all jobs in hold queue 1 that now fit into memory into ready queue
-    for (deque<int>::iterator it = m_hold_queue_1.begin();
-         it != m_hold_queue_1.end();) {
-        int job_id = *it;
-        if (m_jobs.at(job_id).get_max_memory() <= get_available_memory()) {
+    // Move all jobs in hold queue 1 that now fit into memory into ready queue. 
+    // Available memory only goes down during the scan, so it can stop (or be 
+    // skipped) once the smallest job left in the queue does not fit.
+    m_hold_dirty = false;
+    count_hold_scan(m_hold_1_memory);
+    for (ShortestJobQueue::const_iterator it = m_hold_queue_1.begin();
+         it != m_hold_queue_1.end() && hold_queue_can_admit(m_hold_1_memory);) {
+        int job_id = it->job_id;
+        if (m_jobs.get_max_memory(job_id) <= get_available_memory()) {
             it = m_hold_queue_1.erase(it);
-            allocate_memory(m_jobs.at(job_id).get_max_memory());
+            leave_queue(JobQueue::Hold1, job_id);
+            m_hold_1_memory.erase(m_hold_1_memory.find(m_jobs.get_max_memory(job_id)));
+            allocate_memory(m_jobs.get_max_memory(job_id));
             schedule_job(JobQueue::Ready, job_id);
         } else {
             it++;
@@ -353,25 +794,31 @@ void SystemState::update_queues() {
     
     
     // Move all jobs in hold queue 2 that now fit into memory into ready queue
-    for (deque<int>::iterator it = m_hold_queue_2.begin();
-         it != m_hold_queue_2.end();) {
-        int job_id = *it;
-        if (m_jobs.at(job_id).get_max_memory() <= get_available_memory()) {
+    count_hold_scan(m_hold_2_memory);
+    for (ShortestJobQueue::const_iterator it = m_hold_queue_2.begin();
+         it != m_hold_queue_2.end() && hold_queue_can_admit(m_hold_2_memory);) {
+        int job_id = it->job_id;
+        if (m_jobs.get_max_memory(job_id) <= get_available_memory()) {
             it = m_hold_queue_2.erase(it);
-            allocate_memory(m_jobs.at(job_id).get_max_memory());
+            leave_queue(JobQueue::Hold2, job_id);
+            m_hold_2_memory.erase(m_hold_2_memory.find(m_jobs.get_max_memory(job_id)));
+            allocate_memory(m_jobs.get_max_memory(job_id));
             schedule_job(JobQueue::Ready, job_id);
         } else {
             it++;
         }
     }
     
+    // Without demotion the long queue stays empty
     for (deque<int>::iterator it = m_long_queue.begin();
-         it != m_long_queue.end();) {
+         Policy::DEMOTE_LONG_JOBS && it != m_long_queue.end();) {
         m_can_move = false;
         int job_id = *it;
-        if (m_hold_queue_1.empty() && m_hold_queue_2.empty() && m_cpu == NoJob && !m_ready_queue.empty()) {
+        if (Policy::promote_long_job(*this, job_id, m_hold_queue_1.empty() && m_hold_queue_2.empty(), 
+                                     m_cpu == NoJob, has_ready_jobs())) {
             m_can_move = true;
             it = m_long_queue.erase(it);
+            leave_queue(JobQueue::LongQ, job_id);
             schedule_job(JobQueue::Ready, job_id);
         }
         else{
@@ -380,360 +827,238 @@ void SystemState::update_queues() {
     }
     // If no job on CPU, pull next job from ready queue into cpu (if there is 
     // one)
-    if (m_cpu == NoJob && has_next_job(JobQueue::Ready)) {
-        cout << "Job " << get_next_job(JobQueue::Ready) << " placed on the CPU" << endl;
-        cpu_set_job(pop_next_job(JobQueue::Ready));
-    }
-}
-
-// Display code
-
-string::size_type max_length(const vector<string>& strings) {
-    string::size_type max_length = 0;
-    for (const string& s : strings) {
-        if (s.size() > max_length) {
-            max_length = s.size();
-        }
-    }
-    return max_length;
-}
-
-bool queue_contains(const deque<int>& queue, int value) {
-    for (int v : queue) {
-        if (v == value) {
-            return true;
+    if (m_cpu == NoJob && has_ready_jobs()) {
+        int job_id;
+        if constexpr (Policy::ORDER_READY) {
+            job_id = m_ready_order.begin()->job_id;
+            m_ready_order.erase(m_ready_order.begin());
+        } else {
+            job_id = m_ready_queue.front();
+            m_ready_queue.pop_front();
         }
+        TRACE(TraceLevel::Decisions, "Job " << m_jobs.get_number(job_id) << " placed on the CPU");
+        TRACE_DECISION(m_time, Trace::Decision::Cpu, m_jobs.get_number(job_id));
+        leave_queue(JobQueue::Ready, job_id);
+        cpu_set_job(job_id);
     }
-    return false;
-}
-
-string SystemState::get_job_state(int job_id) const {
-    if (m_cpu == job_id) {
-        return "CPU";
-    } else if (queue_contains(m_hold_queue_1, job_id)) {
-        return "Hold queue 1";
-    } else if (queue_contains(m_hold_queue_2, job_id)) {
-        return "Hold queue 2";
-    } else if (queue_contains(m_long_queue, job_id)) {
-        return "Long queue";
-    }else if (queue_contains(m_ready_queue, job_id)) {
-        return "Ready queue";
-    } else if (queue_contains(m_wait_queue, job_id)) {
-        return "Device wait queue";
-    } else if (queue_contains(m_complete_queue, job_id)) {
-        return "Complete at time " + to_string(m_jobs.at(job_id).get_completion_time());
-    } else {
-        return "???";
-    }
-}
-
-string format_time_remaining(int time_remaining) {
-    if (time_remaining == 0) {
-        return "";
-    } else {
-        return to_string(time_remaining);
-    }
-}
-
-string pad_center(const string& contents, char pad_char, unsigned int pad_width) {
-    if (contents.size() >= pad_width) {
-        // Don't need to pad
-        return contents;
-    }
-    int left_pad_width = (pad_width - contents.size()) / 2;
-    int right_pad_width = (pad_width - contents.size()) - left_pad_width;
-    return string(left_pad_width, pad_char) + contents 
-           + string(right_pad_width, pad_char);
 }
 
-string pad_left(const string& contents, char pad_char, unsigned int pad_width) {
-    if (contents.size() >= pad_width) {
-        // Don't need to pad
-        return contents;
-    }
-    return contents + string(pad_width - contents.size(), pad_char);
+/**
+ * Checks if update_queues() would do anything. A pass only has an effect if the 
+ * CPU job's quantum is over, if the CPU is idle with jobs ready, or if devices or 
+ * memory were freed (or the active set changed) since the wait or hold queues 
+ * were last evaluated, and for the hold queues, only if a held job now fits. 
+ * Long queue promotion requires an idle CPU with jobs ready, so it is covered by 
+ * the second condition.
+ */
+bool SystemState::needs_update() const {
+    return (m_cpu != NoJob && m_cpu_quantum_remaining == 0)
+           || (m_cpu == NoJob && has_ready_jobs())
+           || ((m_wait_dirty || m_negative_allocation) && !m_wait_queue.empty())
+           || (m_hold_dirty && (hold_queue_can_admit(m_hold_1_memory) 
+                                || hold_queue_can_admit(m_hold_2_memory)));
 }
 
-string print_table(const vector<vector<string>>& columns,
-                   const vector<string>& headers = vector<string>(),
-                   const string& title = "") {
-    // Table components
-    const string LEFT_COLUMN_BORDER = "| ";
-    const int LEFT_COLUMN_BORDER_WIDTH = LEFT_COLUMN_BORDER.size();
-    const string CENTER_COLUMN_BORDER = " | ";
-    const int CENTER_COLUMN_BORDER_WIDTH = CENTER_COLUMN_BORDER.size();
-    const string RIGHT_COLUMN_BORDER = " |";
-    const int RIGHT_COLUMN_BORDER_WIDTH = RIGHT_COLUMN_BORDER.size();
-    const char TITLE_PADDING = '=';
-    const string TITLE_BORDER = "===";
-    const char HORIZONTAL_BORDER = '-';
-    const char PADDING = ' ';
-    const string EMPTY = "";
-    
-    // Calculate widths
-    vector<int> column_widths;
-    for (unsigned int i = 0; i < columns.size(); i++) {
-        string::size_type width = max_length(columns[i]);
-        if (!headers.empty()) {
-            width = max(width, headers[i].size());
-        }
-        column_widths.push_back(width);
-    }
-    
-    int total_width = accumulate(column_widths.begin(), column_widths.end(), 0)
-                      + LEFT_COLUMN_BORDER_WIDTH 
-                      + RIGHT_COLUMN_BORDER_WIDTH
-                      + CENTER_COLUMN_BORDER_WIDTH * (columns.size() - 1);
-    
-    stringstream ss;
-    // Title
-    if (title.size() > 0) {
-        string title_string = TITLE_BORDER + PADDING + title + PADDING + TITLE_BORDER;
-        ss << pad_center(title_string, TITLE_PADDING, total_width) << endl;
-    }
-    // Headers
-    if (!headers.empty()) {
-        ss << pad_left(EMPTY, HORIZONTAL_BORDER, total_width) << endl;
-        for (unsigned int i = 0; i < headers.size(); i++) {
-            if (i == 0) {
-                ss << LEFT_COLUMN_BORDER;
-            } else {
-                ss << CENTER_COLUMN_BORDER;
-            }
-            ss << pad_left(headers[i], PADDING, column_widths[i]);
-        } 
-        ss << RIGHT_COLUMN_BORDER << endl;
-    }
-    // Columns
-    ss << pad_left(EMPTY, HORIZONTAL_BORDER, total_width) << endl;
-    for (unsigned int j = 0; j < columns[0].size(); j++) {
-        for (unsigned int i = 0; i < columns.size(); i++) {
-            if (i == 0) {
-                ss << LEFT_COLUMN_BORDER;
-            } else {
-                ss << CENTER_COLUMN_BORDER;
-            }
-            ss << pad_left(columns[i][j], PADDING, column_widths[i]);
-        } 
-        ss << RIGHT_COLUMN_BORDER << endl;
-    }
-    ss << pad_left(EMPTY, HORIZONTAL_BORDER, total_width) << endl;
-    
-    return ss.str();
+/**
+ * Checks if any job of a hold queue fits into the available memory, given the 
+ * memory requirements of the jobs in the queue.
+ */
+bool SystemState::hold_queue_can_admit(const multiset<int>& memory) const {
+    return !memory.empty() && *memory.begin() <= get_available_memory();
 }
 
-string SystemState::print_queue_table(const string& queue_name, JobQueue queue) {
-    vector<string> queue_vector;
-    for (int job_id : get_queue(queue)) {
-        queue_vector.push_back(to_string(job_id));
+/**
+ * Counts a scan of a hold queue as performed or, if no job in it fits, skipped.
+ */
+void SystemState::count_hold_scan(const multiset<int>& memory) {
+    if (hold_queue_can_admit(memory)) {
+        m_hold_scans++;
+    } else if (!memory.empty()) {
+        m_hold_scans_skipped++;
     }
-    string queue_table = print_table(
-        { 
-            queue_vector 
-        },
-        {
-            "Jobs"
-        }, 
-        queue_name);
-    return queue_table;
 }
 
-int unweighted_turnaround(const Job& job) {
-    return job.get_completion_time() - job.get_arrival_time();
-}
-
-double weighted_turnaround(const Job& job) {
-    return (job.get_completion_time() - job.get_arrival_time()) 
-           / (double) job.get_runtime();
-}
-
-string format_unweighted_turnaround(int turnaround) {
-    if (turnaround < 0) {
-        return "";
+/**
+ * Runs update_queues() if needs_update(), and counts the pass as skipped otherwise.
+ * @return True if the pass was run, false if it was skipped.
+ */
+bool SystemState::update_queues_if_needed() {
+    if (needs_update()) {
+        update_queues();
+        return true;
     } else {
-        return to_string(turnaround);
+        m_update_passes_skipped++;
+        return false;
     }
 }
 
-string format_weighted_turnaround(double turnaround) {
-    if (turnaround < 0) {
-        return "";
-    } else {
-        return to_string(turnaround);
-    }
-}
-
-string SystemState::to_text(bool include_system_turnaround) {
-    // Print jobs
-    vector<string> job_numbers;
-    vector<string> job_states;
-    vector<string> job_remaining_times;
-    vector<string> job_unweighted_turnaround_times;
-    vector<string> job_weighted_turnaround_times;
-    for (const pair<int, Job>& j : m_jobs) {
-        job_numbers.push_back(to_string(j.first));
-        job_states.push_back(get_job_state(j.first));
-        job_remaining_times.push_back(format_time_remaining(j.second.get_time_remaining()));
-        job_unweighted_turnaround_times.push_back(
-            format_unweighted_turnaround(unweighted_turnaround(j.second)));
-        job_weighted_turnaround_times.push_back(
-            format_weighted_turnaround(weighted_turnaround(j.second)));
-    }
-    string jobs_table = print_table(
-        {
-            job_numbers, 
-            job_states, 
-            job_remaining_times, 
-            job_unweighted_turnaround_times, 
-            job_weighted_turnaround_times
-        },
-        {
-            "#",
-            "State",
-            "Time Remaining",
-            "Turnaround Time (Unweighted)",
-            "Turnaround Time (Weighted)"
-        },
-        "Jobs");
-    
-    // Print queues
-    string hold_queue_1_table = print_queue_table("Hold Queue 1", JobQueue::Hold1);
-    string hold_queue_2_table = print_queue_table("Hold Queue 2", JobQueue::Hold2);
-    string long_queue_table = print_queue_table("Long Queue", JobQueue::LongQ);
-    string ready_queue_table = print_queue_table("Ready Queue", JobQueue::Ready);
-    string wait_queue_table = print_queue_table("Device Wait Queue", JobQueue::Wait);
-    string complete_queue_table = print_queue_table("Complete Queue", JobQueue::Complete);
-    
-    stringstream ss;
-    ss << jobs_table
-       << hold_queue_1_table
-       << hold_queue_2_table
-       << long_queue_table
-       << ready_queue_table
-       << wait_queue_table
-       << complete_queue_table;
-    
-    if (include_system_turnaround) {
-        int sum_unweighted_turnarounds = 0;
-        double sum_weighted_turnarounds = 0;
-        int num_complete_jobs = 0;
-        for (const pair<int, Job>& j : m_jobs) {
-            if (queue_contains(m_complete_queue, j.first)) {
-                sum_unweighted_turnarounds += unweighted_turnaround(j.second);
-                sum_weighted_turnarounds += weighted_turnaround(j.second);
-                num_complete_jobs++;
+// Display code
+
+/**
+ * Copies what a display shows into a snapshot, reusing the snapshot's storage. A 
+ * job in several queues is shown in the first of them in JobQueue order.
+ */
+void SystemState::capture_display(DisplaySnapshot& snapshot, 
+                                  bool include_system_turnaround) const {
+    snapshot.time = m_time;
+    snapshot.total_memory = m_max_memory;
+    snapshot.available_memory = get_available_memory();
+    snapshot.total_devices = m_max_devices;
+    snapshot.available_devices = get_available_devices();
+    snapshot.device_classes = m_device_classes;
+    snapshot.quantum = m_quantum_length;
+    snapshot.running = cpu_get_job_number();
+    snapshot.include_system_turnaround = include_system_turnaround || m_turnaround_stats;
+    snapshot.include_turnaround_deviation = m_turnaround_stats;
+    snapshot.turnarounds = m_turnarounds;
+    snapshot.weighted_turnarounds = m_weighted_turnarounds;
+    snapshot.include_latencies = m_latency_stats;
+    if (m_latency_stats) {
+        for (int latency = 0; latency < DisplaySnapshot::LATENCIES; latency++) {
+            const LatencyHistogram& histogram = m_latencies[latency];
+            DisplaySnapshot::LatencySummary& summary = snapshot.latencies[latency];
+            summary.count = histogram.count();
+            for (int i = 0; i < DisplaySnapshot::LATENCY_PERCENTILE_COUNT; i++) {
+                summary.percentiles[i] = 
+                    histogram.get_percentile(DisplaySnapshot::LATENCY_PERCENTILES[i]);
             }
+            summary.max = histogram.max();
         }
-        double average_unweighted_turnaround = sum_unweighted_turnarounds 
-                                               / (double) num_complete_jobs;
-        ss << "System average unweighted turnaround: " << average_unweighted_turnaround << endl;
-        double average_weighted_turnaround = sum_weighted_turnarounds 
-                                             / (double) num_complete_jobs;
-        ss << "System average weighted turnaround: " << average_weighted_turnaround << endl;
     }
+    snapshot.streaming = m_streaming;
+    snapshot.retired_jobs = m_retired_jobs;
+    snapshot.retired_turnaround_sum = m_retired_turnaround_sum;
+    snapshot.retired_weighted_turnaround_sum = m_retired_weighted_turnaround_sum;
+    snapshot.retired_max_turnaround = m_retired_max_turnaround;
     
-    return ss.str();
-}
-
-string join_ints(const deque<int>& ints, const string& delimiter) {
-    stringstream ss;
-    for (unsigned int i = 0; i < ints.size(); i++) {
-        ss << to_string(ints[i]);
-        if (i != ints.size() - 1) {
-            ss << delimiter;
+    snapshot.jobs.clear();
+    for (const pair<const int, int>& j : m_jobs.get_slots()) {
+        int job_id = j.second;
+        DisplaySnapshot::JobEntry job;
+        job.number = m_jobs.get_number(job_id);
+        job.arrival_time = m_jobs.get_arrival_time(job_id);
+        job.completion_time = m_jobs.get_completion_time(job_id);
+        job.runtime = m_jobs.get_runtime(job_id);
+        job.time_remaining = m_jobs.get_time_remaining(job_id);
+        if (m_cpu == job_id) {
+            job.location = DisplaySnapshot::Location::Cpu;
+        } else {
+            switch (m_jobs.get_first_queue(job_id)) {
+                case static_cast<int>(JobQueue::Hold1): 
+                    job.location = DisplaySnapshot::Location::Hold1; break;
+                case static_cast<int>(JobQueue::Hold2): 
+                    job.location = DisplaySnapshot::Location::Hold2; break;
+                case static_cast<int>(JobQueue::LongQ): 
+                    job.location = DisplaySnapshot::Location::LongQ; break;
+                case static_cast<int>(JobQueue::Ready): 
+                    job.location = DisplaySnapshot::Location::Ready; break;
+                case static_cast<int>(JobQueue::Wait): 
+                    job.location = DisplaySnapshot::Location::Wait; break;
+                case static_cast<int>(JobQueue::Complete): 
+                    job.location = DisplaySnapshot::Location::Complete; break;
+                default: 
+                    job.location = DisplaySnapshot::Location::Unknown; break;
+            }
         }
+        job.devices_shown = is_in_queue(JobQueue::Ready, job_id) 
+                            || is_in_queue(JobQueue::Wait, job_id)
+                            || m_cpu == job_id;
+        job.complete = is_in_queue(JobQueue::Complete, job_id);
+        job.allocated_devices = m_jobs.get_allocated_devices(job_id);
+        snapshot.jobs.push_back(job);
     }
-    return ss.str();
-}
-
-string join_strings(const vector<string>& strings, const string& delimiter) {
-    stringstream ss;
-    for (unsigned int i = 0; i < strings.size(); i++) {
-        ss << strings[i];
-        if (i != strings.size() - 1) {
-            ss << delimiter;
-        }
+    
+    capture_job_numbers(m_hold_queue_1, snapshot.hold_queue_1);
+    capture_job_numbers(m_hold_queue_2, snapshot.hold_queue_2);
+    capture_job_numbers(m_long_queue, snapshot.long_queue);
+    if (m_ready_order.empty()) {
+        capture_job_numbers(m_ready_queue, snapshot.ready_queue);
+    } else {
+        capture_job_numbers(m_ready_order, snapshot.ready_queue);
     }
-    return ss.str();
+    capture_job_numbers(m_wait_queue, snapshot.wait_queue);
+    capture_job_numbers(m_complete_queue, snapshot.complete_queue);
 }
 
-string SystemState::print_job(const Job& job) {
-    stringstream ss;
-    ss << "{"
-       << "\"arrival_time\": " << job.get_arrival_time() << ", ";
-    if (queue_contains(m_ready_queue, job.get_number()) 
-        || queue_contains(m_wait_queue, job.get_number())
-        || m_cpu == job.get_number()) {
-        ss << "\"devices_allocated\": " << job.get_allocated_devices() << ", ";
-    }
-    ss << "\"id\": " << job.get_number() << ", "
-       << "\"remaining_time\": " << job.get_time_remaining();
-    if (queue_contains(m_complete_queue, job.get_number())) {
-        ss << ", "
-           << "\"completion_time\": " << job.get_completion_time();
+void SystemState::capture_job_numbers(const deque<int>& queue, vector<int>& numbers) const {
+    numbers.clear();
+    for (int job_id : queue) {
+        numbers.push_back(m_jobs.get_number(job_id));
     }
-    ss << "}";
-    
-    return ss.str();
 }
 
-string SystemState::to_json(bool include_system_turnaround) {
-    stringstream ss;
-    
-    vector<string> job_strings;
-    for (const pair<int, Job>& j : m_jobs) {
-        job_strings.push_back(print_job(j.second));
+void SystemState::capture_job_numbers(const ShortestJobQueue& queue, 
+                                      vector<int>& numbers) const {
+    numbers.clear();
+    for (const ShortestJobQueue::Entry& entry : queue) {
+        numbers.push_back(m_jobs.get_number(entry.job_id));
     }
-    
-    const string DELIMITER = ", ";
-    
-    ss << "{"
-       << "\"readyq\": [" << join_ints(m_ready_queue, DELIMITER) << "]" << DELIMITER
-       << "\"current_time\": " << m_time << DELIMITER
-       << "\"total_memory\": " << m_max_memory << DELIMITER
-       << "\"available_memory\": " << get_available_memory() << DELIMITER
-       << "\"total_devices\": " << m_max_devices << DELIMITER
-       << "\"running\" :" << m_cpu << DELIMITER
-       << "\"submitq\": []" << DELIMITER
-       << "\"longq\": [" << join_ints(m_long_queue, DELIMITER) << "]" << DELIMITER
-       << "\"holdq2\": [" << join_ints(m_hold_queue_2, DELIMITER) << "]" << DELIMITER
-       << "\"job\": [" << join_strings(job_strings, DELIMITER) << "]" << DELIMITER
-       << "\"holdq1\": [" << join_ints(m_hold_queue_1, DELIMITER) << "]" << DELIMITER
-       << "\"available_devices\": " << get_available_devices() << DELIMITER
-       << "\"quantum\": " << m_quantum_length << DELIMITER
-       << "\"completeq\": [" << join_ints(m_complete_queue, DELIMITER) << "]" << DELIMITER
-       << "\"waitq\": [" << join_ints(m_wait_queue, DELIMITER) << "]";
-       
-    if (include_system_turnaround) {
-        ss << DELIMITER;
-        int sum_unweighted_turnarounds = 0;
-        double sum_weighted_turnarounds = 0;
-        int num_complete_jobs = 0;
-        for (const pair<int, Job>& j : m_jobs) {
-            if (queue_contains(m_complete_queue, j.first)) {
-                sum_unweighted_turnarounds += unweighted_turnaround(j.second);
-                sum_weighted_turnarounds += weighted_turnaround(j.second);
-                num_complete_jobs++;
-            }
-        }
-        double average_unweighted_turnaround = sum_unweighted_turnarounds 
-                                               / (double) num_complete_jobs;
-        ss << "\"turnaround\": " << average_unweighted_turnaround << DELIMITER;
-        double average_weighted_turnaround = sum_weighted_turnarounds 
-                                             / (double) num_complete_jobs;
-        ss << "\"weighted_turnaround\": " << average_weighted_turnaround;
-    }
-    ss << "}";
-    
-    return ss.str();
 }
 
 void SystemState::print_event_queue() const {
     cout << "=== PRINT EVENT QUEUE ===" << endl;
-    for (const Event* const e : m_event_queue) {
+    if (!m_cpu_timers.empty()) {
+        cout << m_cpu_timers.next_expiry() << ": Internal (CPU timer)" << endl;
+    }
+    for (const Event* const e : m_event_queue.sorted()) {
         cout << e->get_time() << ": " 
              << ((e->get_type() == Event::Type::Internal) ? "Internal" : "External")
              << endl;
     }
+    for (const EventRecord& r : m_record_queue.sorted()) {
+        cout << r.get_time() << ": " 
+             << ((r.get_type() == Event::Type::Internal) ? "Internal" : "External")
+             << endl;
+    }
     cout << "=========================" << endl;
 }
+
+void SystemState::print_stats(ostream& out) const {
+    double event_loop_seconds = chrono::duration<double>(m_event_loop_time).count();
+    out << "=== STATISTICS ===" << endl;
+    out << "engine: " << ((m_engine == EventEngine::Variant) ? "variant" : "virtual") 
+        << endl;
+    with_policy([&](auto policy) {
+        out << "policy: " << decltype(policy)::NAME << endl;
+    });
+    out << "events_processed: " << m_events_processed << endl;
+    out << "event_loop_seconds: " << event_loop_seconds << endl;
+    if (event_loop_seconds > 0) {
+        out << "events_per_second: " << m_events_processed / event_loop_seconds << endl;
+    }
+    out << "update_passes: " << m_update_passes << endl;
+    out << "update_passes_skipped: " << m_update_passes_skipped << endl;
+    out << "cpu_timers_armed: " << m_dispatch_generation << endl;
+    out << "stale_timer_firings_avoided: " << m_stale_timers_cancelled << endl;
+    out << "stale_timer_firings: " << m_stale_timer_firings << endl;
+    out << "wait_scans: " << m_wait_scans << endl;
+    out << "wait_scans_skipped: " << m_wait_scans_skipped << endl;
+    out << "bankers_checks: " << m_bankers_checks << endl;
+    out << "hold_scans: " << m_hold_scans << endl;
+    out << "hold_scans_skipped: " << m_hold_scans_skipped << endl;
+    out << "jobs_retired: " << m_retired_jobs << endl;
+    out << "live_jobs_high_water: " << m_live_jobs_high_water << endl;
+    out << "jobs_completed: " << m_turnarounds.count() << endl;
+    out << "turnaround_mean: " << m_turnarounds.mean() << endl;
+    out << "turnaround_stddev: " << m_turnarounds.standard_deviation() << endl;
+    out << "weighted_turnaround_mean: " << m_weighted_turnarounds.mean() << endl;
+    out << "weighted_turnaround_stddev: " << m_weighted_turnarounds.standard_deviation() << endl;
+    double display_seconds = chrono::duration<double>(m_display_time).count();
+    out << "displays: " << m_displays << endl;
+    out << "display_seconds: " << display_seconds << endl;
+    if (m_display_jobs > 0) {
+        out << "display_ns_per_job: " << display_seconds * 1e9 / m_display_jobs << endl;
+    }
+    if (m_snapshot_writer != nullptr) {
+        m_snapshot_writer->print_stats(out);
+    } else {
+        m_display_writer.print_stats(out);
+    }
+    m_event_pool.print_stats(out);
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        // ru_maxrss is in kilobytes on Linux
+        out << "peak_rss_kb: " << usage.ru_maxrss << endl;
+    }
+    out << "==================" << endl;
+}
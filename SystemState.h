@@ -2,16 +2,34 @@
 #define _SYSTEM_STATE_H_
 
 #include <deque>
+#include <set>
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <ostream>
+#include <utility>
+#include <cstddef>
+#include <chrono>
 
 #include "Job.h"
+#include "JobTable.h"
+#include "ShortestJobQueue.h"
+#include "DeviceNeedIndex.h"
 #include "Event.h"
-#include "QuantumEndEvent.h"
+#include "EventQueue.h"
+#include "EventPool.h"
+#include "EventRecord.h"
+#include "TimingWheel.h"
+#include "Options.h"
+#include "OutputBuffer.h"
+#include "DisplaySnapshot.h"
+#include "RunningStats.h"
+#include "LatencyHistogram.h"
 
 #define END_TIME 9999
 
+class SnapshotWriter;
+
 /**
  * @class SystemState
  * @brief Represents the current state of the system.
@@ -31,18 +49,25 @@ public:
         Complete,
     };
     
-    SystemState(int max_memory, int time_excess, int max_devices, int quantum_length, int time);
+    SystemState(int max_memory, int time_excess, const DeviceVector& max_devices, 
+                int device_classes, int quantum_length, int time, 
+                const Options& options = Options());
+    ~SystemState();
+    
+    SystemState(const SystemState&) = delete;
+    SystemState& operator= (const SystemState&) = delete;
     
     int get_max_memory() const;
     int get_time_excess() const;
-    int get_max_devices() const;
+    const DeviceVector& get_max_devices() const;
+    int get_device_classes() const;
     int get_allocated_memory() const;
-    int get_allocated_devices() const;
+    const DeviceVector& get_allocated_devices() const;
     int get_available_memory() const;
-    int get_available_devices() const;
+    DeviceVector get_available_devices() const;
     
-    void cpu_request_devices(int devices);
-    void cpu_release_devices(int devices);
+    void cpu_request_devices(const DeviceVector& devices);
+    void cpu_release_devices(const DeviceVector& devices);
     
     void allocate_memory(int memory);
     void release_memory(int memory);
@@ -53,55 +78,177 @@ public:
     void set_time(int time);
     void end_quantum();
     
+    /**
+     * @brief Constructs an event in the system's event pool.
+     * 
+     * Events made here must be returned with release_event() rather than deleted.
+     */
+    template <typename T, typename... Args>
+    T* new_event(Args&&... args) {
+        return m_event_pool.make<T>(std::forward<Args>(args)...);
+    }
+    void release_event(Event* e);
+    
     void schedule_event(Event* e);
-    bool has_next_event() const;
     Event* get_next_event() const;
     Event* pop_next_event();
     
-    void add_job(const Job& job);
+    // Engine-independent event interface; these use pooled Event objects or 
+    // EventRecord values depending on Options::engine
+    void schedule_arrival(int time, const Job& job);
+    void schedule_device_request(int time, int job_number, 
+                                 const DeviceVector& requested_devices);
+    void schedule_device_release(int time, int job_number, 
+                                 const DeviceVector& released_devices);
+    void schedule_display(int time, const std::string& filename);
+    bool has_next_event() const;
+    int get_next_event_time() const;
+    void process_next_event();
+    RecordDeviceTable& get_record_devices();
+    void record_event_loop_time(std::chrono::steady_clock::duration elapsed);
+    void record_display_time(std::chrono::steady_clock::duration elapsed);
+    
+    // Jobs are identified by their slot in the job table (job_id below), and 
+    // only displays and messages use job numbers
+    int add_job(const Job& job);
+    const JobTable& get_jobs() const;
     
     void schedule_job(JobQueue queue, int job_id);
     bool has_next_job(JobQueue queue);
     int get_next_job(JobQueue queue);
     int pop_next_job(JobQueue queue);
     bool m_can_move = false;
-
+    
     void cpu_set_job(int job_id);
     int cpu_get_job() const;
+    int cpu_get_job_number() const;
     
     void update_queues();
+    bool needs_update() const;
+    bool update_queues_if_needed();
     bool bankers_valid(int requester_id) const;
+    bool bankers_valid_textbook(int requester_id) const;
     
-    std::string to_text(bool include_system_turnaround);
-    std::string to_json(bool include_system_turnaround);
+    // Displays are rendered from a snapshot, either on the simulation thread 
+    // (by the display writer) or on the thread of a snapshot writer, if set
+    void capture_display(DisplaySnapshot& snapshot, bool include_system_turnaround) const;
+    DisplaySnapshot& get_display_snapshot();
+    DisplayWriter& get_display_writer();
+    void set_snapshot_writer(SnapshotWriter* writer);
+    SnapshotWriter* get_snapshot_writer() const;
     
     void print_event_queue() const;
+    void print_stats(std::ostream& out) const;
 private:
     int m_max_memory;
     int m_time_excess;
-    int m_max_devices;
+    DeviceVector m_max_devices;
+    int m_device_classes;
     int m_quantum_length;
     
     int m_allocated_memory;
-    int m_allocated_devices;
+    DeviceVector m_allocated_devices;
     int m_time;
-
-    std::unordered_map<int, Job> m_jobs;
-    std::deque<Event*> m_event_queue;
-    std::deque<int> m_hold_queue_1;
-    std::deque<int> m_hold_queue_2;
+    
+    JobTable m_jobs;
+    EventPool m_event_pool;
+    EventEngine m_engine;
+    EventQueue<Event*> m_event_queue;
+    EventQueue<EventRecord> m_record_queue;
+    RecordDeviceTable m_record_devices;
+    unsigned long m_events_processed;
+    std::chrono::steady_clock::duration m_event_loop_time;
+    DisplaySnapshot m_display_snapshot;
+    DisplayWriter m_display_writer;
+    SnapshotWriter* m_snapshot_writer;
+    unsigned long m_displays;
+    unsigned long m_display_jobs;
+    std::chrono::steady_clock::duration m_display_time;
+    
+    // Quantum timers of CPU dispatches; a timer is tagged with the dispatch 
+    // generation so that stale firings can be recognized
+    TimingWheel m_cpu_timers;
+    TimingWheel::Handle m_cpu_timer;
+    unsigned long m_dispatch_generation;
+    bool m_fire_stale_timers;
+    unsigned long m_stale_timers_cancelled;
+    unsigned long m_stale_timer_firings;
+    
+    // Set when a change may let jobs leave the wait queue (devices freed, or the 
+    // set of active jobs changed) or the hold queues (memory freed), and cleared 
+    // when update_queues() re-evaluates that queue
+    bool m_wait_dirty;
+    bool m_hold_dirty;
+    unsigned long m_update_passes;
+    unsigned long m_update_passes_skipped;
+    unsigned long m_wait_scans;
+    unsigned long m_wait_scans_skipped;
+    mutable unsigned long m_bankers_checks;
+    bool m_negative_allocation;
+    
+    // The active jobs (CPU, ready and wait queues) by device need
+    DeviceNeedIndex m_need_index;
+    bool m_bankers_inclusive;
+    bool m_check_bankers;
+    ShortestJobQueue m_hold_queue_1;
+    ShortestJobQueue m_hold_queue_2;
     std::deque<int> m_long_queue;
+    // The ready queue is m_ready_queue, or m_ready_order for policies that order 
+    // it (see SchedulingPolicies.h); the other one stays empty
     std::deque<int> m_ready_queue;
+    ShortestJobQueue m_ready_order;
     std::deque<int> m_wait_queue;
     int m_cpu;
     int m_cpu_quantum_remaining;
+    SchedulingPolicy m_policy;
     std::deque<int> m_complete_queue;
     
+    // Completed jobs folded out of m_jobs in streaming mode
+    bool m_streaming;
+    unsigned long m_retired_jobs;
+    long m_retired_turnaround_sum;
+    double m_retired_weighted_turnaround_sum;
+    int m_retired_max_turnaround;
+    std::size_t m_live_jobs_high_water;
+    
+    // Turnarounds of all completed jobs, including retired ones, updated as jobs 
+    // complete so that displays do not have to add them up
+    RunningStats m_turnarounds;
+    RunningStats m_weighted_turnarounds;
+    bool m_turnaround_stats;
+    
+    // Distributions of the time jobs spend in each state (indexed by 
+    // DisplaySnapshot::Latency), recorded as jobs move between queues
+    LatencyHistogram m_latencies[DisplaySnapshot::LATENCIES];
+    bool m_latency_stats;
+    
+    // Memory requirements of the jobs in each hold queue, so that a scan can be 
+    // skipped or cut short when no held job fits into the available memory
+    std::multiset<int> m_hold_1_memory;
+    std::multiset<int> m_hold_2_memory;
+    unsigned long m_hold_scans;
+    unsigned long m_hold_scans_skipped;
+    
+    template <typename Function>
+    void with_policy(Function function) const;
+    template <typename Policy>
+    void update_queues_with();
+    void enter_queue(JobQueue queue, int job_id);
+    void leave_queue(JobQueue queue, int job_id);
+    bool is_in_queue(JobQueue queue, int job_id) const;
+    bool hold_queue_can_admit(const std::multiset<int>& memory) const;
+    void count_hold_scan(const std::multiset<int>& memory);
+    // The hold queues and an ordered ready queue are not deques, so they are not 
+    // available here
     std::deque<int>& get_queue(JobQueue queue);
+    bool has_ready_jobs() const;
+    bool job_is_queued(int job_id) const;
+    void retire_job(int job_id);
+    void record_completion(int job_id, int time);
+    LatencyHistogram& get_latency(DisplaySnapshot::Latency latency);
     void allocate_requested_devices(int job_id);
-    std::string get_job_state(int job_id) const;
-    std::string print_queue_table(const std::string& queue_name, JobQueue queue);
-    std::string print_job(const Job& job);
+    void capture_job_numbers(const std::deque<int>& queue, std::vector<int>& numbers) const;
+    void capture_job_numbers(const ShortestJobQueue& queue, std::vector<int>& numbers) const;
 };
 
 #endif // _SYSTEM_STATE_H_
@@ -0,0 +1,159 @@
+#include <stdexcept>
+
+#include "TimingWheel.h"
+
+using namespace std;
+
+TimingWheel::TimingWheel(int now) 
+: m_now(now), m_nodes(), m_free(NoTimer), m_size(0), 
+  m_lists(LEVELS * SLOTS + 1, { NoTimer, NoTimer }), m_occupied() {
+}
+
+TimingWheel::Handle TimingWheel::arm(int expiry, unsigned long generation) {
+    if (expiry < m_now) {
+        throw runtime_error("Error: Timer armed in the past.");
+    }
+    int node;
+    if (m_free != NoTimer) {
+        node = m_free;
+        m_free = m_nodes[node].next;
+    } else {
+        node = m_nodes.size();
+        m_nodes.push_back(Node());
+    }
+    m_nodes[node].expiry = expiry;
+    m_nodes[node].generation = generation;
+    place(node);
+    m_size++;
+    return node;
+}
+
+void TimingWheel::cancel(Handle handle) {
+    unlink(handle);
+    m_nodes[handle].next = m_free;
+    m_free = handle;
+    m_size--;
+}
+
+/**
+ * Moves the wheel to a new time. At every level, the slot that contains the new 
+ * time holds timers that now belong to a lower level, so they are re-placed, 
+ * from the top level down so that timers can fall through several levels.
+ */
+void TimingWheel::advance(int now) {
+    if (now == m_now) {
+        return;
+    }
+    m_now = now;
+    cascade(OVERFLOW_LIST);
+    for (int level = LEVELS - 1; level > 0; level--) {
+        int slot = (m_now >> (level * SLOT_BITS)) & (SLOTS - 1);
+        cascade(level * SLOTS + slot);
+    }
+}
+
+bool TimingWheel::empty() const {
+    return m_size == 0;
+}
+
+int TimingWheel::next_expiry() const {
+    return m_nodes[earliest_node()].expiry;
+}
+
+TimingWheel::Timer TimingWheel::pop() {
+    int node = earliest_node();
+    Timer timer = { m_nodes[node].expiry, m_nodes[node].generation };
+    cancel(node);
+    return timer;
+}
+
+/**
+ * Puts a node in the list for its expiry: level 0 if it expires in the current 
+ * block of SLOTS time units, otherwise the lowest level whose enclosing block it 
+ * shares with the current time, otherwise the overflow list.
+ */
+void TimingWheel::place(int node) {
+    int expiry = m_nodes[node].expiry;
+    for (int level = 0; level < LEVELS; level++) {
+        int shift = (level + 1) * SLOT_BITS;
+        if ((expiry >> shift) == (m_now >> shift)) {
+            int slot = (expiry >> (level * SLOT_BITS)) & (SLOTS - 1);
+            link(level * SLOTS + slot, node);
+            return;
+        }
+    }
+    link(OVERFLOW_LIST, node);
+}
+
+void TimingWheel::link(int list, int node) {
+    Node& n = m_nodes[node];
+    n.list = list;
+    n.prev = m_lists[list].tail;
+    n.next = NoTimer;
+    if (m_lists[list].tail == NoTimer) {
+        m_lists[list].head = node;
+    } else {
+        m_nodes[m_lists[list].tail].next = node;
+    }
+    m_lists[list].tail = node;
+    if (list != OVERFLOW_LIST) {
+        m_occupied[list / SLOTS] |= uint64_t(1) << (list % SLOTS);
+    }
+}
+
+void TimingWheel::unlink(int node) {
+    Node& n = m_nodes[node];
+    if (n.prev == NoTimer) {
+        m_lists[n.list].head = n.next;
+    } else {
+        m_nodes[n.prev].next = n.next;
+    }
+    if (n.next == NoTimer) {
+        m_lists[n.list].tail = n.prev;
+    } else {
+        m_nodes[n.next].prev = n.prev;
+    }
+    if (m_lists[n.list].head == NoTimer && n.list != OVERFLOW_LIST) {
+        m_occupied[n.list / SLOTS] &= ~(uint64_t(1) << (n.list % SLOTS));
+    }
+}
+
+// Detaches the whole list before re-placing its nodes, since a node may be 
+// placed back into the same list
+void TimingWheel::cascade(int list) {
+    int node = m_lists[list].head;
+    m_lists[list].head = NoTimer;
+    m_lists[list].tail = NoTimer;
+    if (list != OVERFLOW_LIST) {
+        m_occupied[list / SLOTS] &= ~(uint64_t(1) << (list % SLOTS));
+    }
+    while (node != NoTimer) {
+        int next = m_nodes[node].next;
+        place(node);
+        node = next;
+    }
+}
+
+/**
+ * Finds the earliest timer. Every timer on a level expires before every timer 
+ * on the levels above it, and within a level the slots after the current 
+ * position are in expiry order, so the earliest timer is in the first occupied 
+ * slot of the lowest occupied level. A level 0 slot holds a single expiry, so 
+ * its head is the earliest; higher slots and the overflow list are scanned.
+ */
+int TimingWheel::earliest_node() const {
+    int list = OVERFLOW_LIST;
+    for (int level = 0; level < LEVELS; level++) {
+        if (m_occupied[level] != 0) {
+            list = level * SLOTS + __builtin_ctzll(m_occupied[level]);
+            break;
+        }
+    }
+    int earliest = m_lists[list].head;
+    for (int node = m_nodes[earliest].next; node != NoTimer; node = m_nodes[node].next) {
+        if (m_nodes[node].expiry < m_nodes[earliest].expiry) {
+            earliest = node;
+        }
+    }
+    return earliest;
+}
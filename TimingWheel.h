@@ -0,0 +1,120 @@
+#ifndef _TIMING_WHEEL_H_
+#define _TIMING_WHEEL_H_
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @class TimingWheel
+ * @brief A hierarchical timing wheel holding timers with O(1) arm and cancel.
+ * 
+ * The wheel has LEVELS levels of SLOTS slots each. Level 0 holds timers expiring 
+ * in the current block of SLOTS time units, one slot per time unit. Level k holds 
+ * timers in the current block of SLOTS^(k+1) time units but outside the current 
+ * block of SLOTS^k, one slot per sub-block. Timers beyond the top level are kept 
+ * in an overflow list. As time advances, the timers in the slot containing the 
+ * new time are moved down to the level that now fits them.
+ * 
+ * Each slot is an intrusive doubly-linked list of nodes, and each level keeps a 
+ * bitmap of its non-empty slots, so finding the earliest timer is a bit scan.
+ * 
+ * Time must never be advanced past the earliest armed timer; pop it first.
+ */
+class TimingWheel {
+public:
+    /**
+     * @struct Timer
+     * @brief An expired timer.
+     */
+    struct Timer {
+        int expiry; /**< The time at which the timer expires. */
+        unsigned long generation; /**< The tag the timer was armed with. */
+    };
+    
+    /** A handle to an armed timer, used to cancel it. */
+    typedef int Handle;
+    
+    /** The handle value that never refers to an armed timer. */
+    static constexpr Handle NoTimer = -1;
+    
+    /**
+     * @brief Constructs an empty wheel.
+     * @param now The current time.
+     */
+    explicit TimingWheel(int now);
+    
+    /**
+     * @brief Arms a timer.
+     * @param expiry The time at which the timer expires; must not be in the past.
+     * @param generation A tag returned with the timer when it expires.
+     * @return A handle that can be passed to cancel().
+     */
+    Handle arm(int expiry, unsigned long generation);
+    
+    /**
+     * @brief Cancels an armed timer.
+     * @param handle The handle returned by arm(); the timer must not have expired.
+     */
+    void cancel(Handle handle);
+    
+    /**
+     * @brief Advances the current time.
+     * @param now The new time; must not be later than next_expiry().
+     */
+    void advance(int now);
+    
+    /**
+     * @brief Checks if any timers are armed.
+     * @return True if no timers are armed, false otherwise.
+     */
+    bool empty() const;
+    
+    /**
+     * @brief Gets the expiry of the earliest armed timer. The wheel must not be empty.
+     * @return The earliest expiry.
+     */
+    int next_expiry() const;
+    
+    /**
+     * @brief Removes the earliest armed timer. The wheel must not be empty.
+     * 
+     * Timers with equal expiries are removed in the order they were armed.
+     * 
+     * @return The removed timer.
+     */
+    Timer pop();
+    
+private:
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr int LEVELS = 4;
+    static constexpr int OVERFLOW_LIST = LEVELS * SLOTS;
+    
+    struct Node {
+        int expiry;
+        unsigned long generation;
+        int list;
+        int prev;
+        int next;
+    };
+    
+    struct List {
+        int head;
+        int tail;
+    };
+    
+    void place(int node);
+    void link(int list, int node);
+    void unlink(int node);
+    void cascade(int list);
+    int earliest_node() const;
+    
+    int m_now;
+    std::vector<Node> m_nodes;
+    int m_free;
+    int m_size;
+    std::vector<List> m_lists;
+    uint64_t m_occupied[LEVELS];
+};
+
+#endif // _TIMING_WHEEL_H_
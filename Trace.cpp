@@ -0,0 +1,41 @@
+#include "Trace.h"
+
+using namespace std;
+
+int Trace::s_level = static_cast<int>(TraceLevel::Time);
+vector<Trace::DecisionRecord> Trace::s_decisions;
+size_t Trace::s_next_decision = 0;
+unsigned long Trace::s_decisions_recorded = 0;
+
+void Trace::record_decisions(size_t capacity) {
+    s_decisions.assign(capacity, DecisionRecord());
+    s_next_decision = 0;
+    s_decisions_recorded = 0;
+}
+
+void Trace::dump_decisions(ostream& out) {
+    size_t count = (s_decisions_recorded < s_decisions.size()) ? s_decisions_recorded 
+                                                               : s_decisions.size();
+    out << "=== LAST " << count << " OF " << s_decisions_recorded 
+        << " SCHEDULER DECISIONS ===" << endl;
+    // The oldest kept decision is the next one to be overwritten, once full
+    size_t start = (s_decisions_recorded < s_decisions.size()) ? 0 : s_next_decision;
+    for (size_t i = 0; i < count; i++) {
+        const DecisionRecord& record = s_decisions[(start + i) % s_decisions.size()];
+        out << record.time << ": Job " << record.job_number;
+        switch (record.decision) {
+            case Decision::Hold1: out << " placed in hold queue 1"; break;
+            case Decision::Hold2: out << " placed in hold queue 2"; break;
+            case Decision::LongQ: out << " placed in long queue"; break;
+            case Decision::Ready: out << " placed in ready queue"; break;
+            case Decision::Wait: out << " placed in wait queue"; break;
+            case Decision::Complete: out << " placed in complete queue"; break;
+            case Decision::Cpu: out << " placed on the CPU"; break;
+            case Decision::Finished: out << " is complete"; break;
+            case Decision::LongJob: out << " is a long job"; break;
+            case Decision::Rejected: out << " rejected"; break;
+        }
+        out << endl;
+    }
+    out << "=========================" << endl;
+}
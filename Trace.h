@@ -0,0 +1,129 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <vector>
+#include <ostream>
+#include <iostream>
+#include <cstddef>
+
+/**
+ * @enum TraceLevel
+ * @brief How much the simulator reports about what it does. Each level includes 
+ * the ones before it.
+ */
+enum class TraceLevel : int {
+    None = 0,      /**< Nothing but displays and errors. */
+    Events = 1,    /**< A line per processed event, such as "3: Job arrival". */
+    Decisions = 2, /**< A line per scheduler decision, such as "Job 1 placed on the CPU". */
+    Time = 3,      /**< A line per clock change ("Time set to ..."). */
+};
+
+/**
+ * The most detailed level compiled in, set with make TRACE_LEVEL=<0-3>. Trace 
+ * statements of higher levels compile to nothing.
+ */
+#ifndef TRACE_MAX_LEVEL
+#define TRACE_MAX_LEVEL 3
+#endif
+
+/**
+ * Whether the decision ring buffer (--trace-decisions) is compiled in, set with 
+ * make TRACE_DECISIONS=<0-1>. It does not depend on TRACE_MAX_LEVEL.
+ */
+#ifndef TRACE_DECISIONS
+#define TRACE_DECISIONS 1
+#endif
+
+/**
+ * @class Trace
+ * @brief The simulator's trace output, shared by the whole program like std::cout.
+ * 
+ * Trace lines are written to std::cout without flushing it, so they are written 
+ * in large blocks (std::cerr still flushes std::cout before it writes, so errors 
+ * stay in place). Use the TRACE macro, which skips formatting for levels that 
+ * are off and compiles out levels above TRACE_MAX_LEVEL.
+ * 
+ * Scheduler decisions can also be recorded in binary form in a ring buffer that 
+ * keeps the last N of them, which is cheap enough to leave on for long runs and 
+ * is printed with dump_decisions() after the run, for example when it failed.
+ */
+class Trace {
+public:
+    /** @brief A scheduler decision recorded in the ring buffer. */
+    enum class Decision : unsigned char {
+        Hold1,     /**< Placed in hold queue 1. */
+        Hold2,     /**< Placed in hold queue 2. */
+        LongQ,     /**< Placed in the long queue. */
+        Ready,     /**< Placed in the ready queue. */
+        Wait,      /**< Placed in the device wait queue. */
+        Complete,  /**< Placed in the complete queue. */
+        Cpu,       /**< Placed on the CPU. */
+        Finished,  /**< Ran to completion and released its memory and devices. */
+        LongJob,   /**< Moved to the long queue for running too long. */
+        Rejected,  /**< Rejected for needing more than the system has. */
+    };
+    
+    static void set_level(TraceLevel level) { s_level = static_cast<int>(level); }
+    static bool enabled(TraceLevel level) { return static_cast<int>(level) <= s_level; }
+    static std::ostream& out() { return std::cout; }
+    
+    /**
+     * @brief Starts recording the last decisions.
+     * @param capacity The number of decisions kept; 0 stops recording.
+     */
+    static void record_decisions(std::size_t capacity);
+    static bool recording_decisions() { return !s_decisions.empty(); }
+    
+    static void record(int time, Decision decision, int job_number) {
+        DecisionRecord& record = s_decisions[s_next_decision];
+        record.time = time;
+        record.job_number = job_number;
+        record.decision = decision;
+        s_next_decision = (s_next_decision + 1 == s_decisions.size()) ? 0 : s_next_decision + 1;
+        s_decisions_recorded++;
+    }
+    
+    /** @brief Prints the recorded decisions, oldest first. */
+    static void dump_decisions(std::ostream& out);
+
+private:
+    struct DecisionRecord {
+        int time;
+        int job_number;
+        Decision decision;
+    };
+    
+    static int s_level;
+    static std::vector<DecisionRecord> s_decisions;
+    static std::size_t s_next_decision;
+    static unsigned long s_decisions_recorded;
+};
+
+/**
+ * Writes a trace line if its level is on, for example 
+ *     TRACE(TraceLevel::Events, time << ": Job arrival");
+ * The message is only formatted if the line is written.
+ */
+#define TRACE(level, message) \
+    do { \
+        if constexpr (static_cast<int>(level) <= TRACE_MAX_LEVEL) { \
+            if (Trace::enabled(level)) { \
+                Trace::out() << message << '\n'; \
+            } \
+        } \
+    } while (0)
+
+/**
+ * Records a scheduler decision in the ring buffer if it is on. Decisions are 
+ * compiled out with TRACE_DECISIONS=0, whatever TRACE_MAX_LEVEL is.
+ */
+#define TRACE_DECISION(time, decision, job_number) \
+    do { \
+        if constexpr (TRACE_DECISIONS) { \
+            if (Trace::recording_decisions()) { \
+                Trace::record((time), (decision), (job_number)); \
+            } \
+        } \
+    } while (0)
+
+#endif // _TRACE_H_
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+
+#include "MappedFile.h"
+#include "CommandParser.h"
+#include "BinaryTrace.h"
+
+using namespace std;
+
+/**
+ * Converts a text input file to the binary trace format (see BinaryTrace.h), 
+ * which project_cs641 reads directly. Usage: trace_converter <input> <output>
+ * 
+ * The display files of a binary trace are named after the binary file, so 
+ * converting test1.txt to test1.bin keeps the names test1_D<time>.json.
+ * 
+ * @param argc The number of command line arguments.
+ * @param argv An array of command line arguments.
+ * @return Returns 0 upon successful conversion.
+ * @throws runtime_error If the arguments are missing, a file cannot be opened, 
+ * or the input is malformed.
+ */
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        throw runtime_error("Error: Please specify an input file and an output file.");
+    }
+    MappedFile in_file(argv[1]);
+    ofstream out_file(argv[2], ios::binary);
+    if (out_file.fail()) {
+        throw runtime_error("Error: Could not open specified output file.");
+    }
+    
+    CommandParser parser(in_file.contents());
+    BinaryTraceWriter writer(out_file);
+    unsigned long commands = 0;
+    for (Command command; parser.next(command);) {
+        writer.write(command);
+        commands++;
+    }
+    streamoff bytes = out_file.tellp();
+    out_file.close();
+    if (out_file.fail()) {
+        throw runtime_error("Error: Could not write specified output file.");
+    }
+    
+    cout << "Converted " << commands << " commands (" << in_file.contents().size() 
+         << " bytes) to " << bytes << " bytes" << endl;
+    return 0;
+}
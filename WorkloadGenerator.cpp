@@ -0,0 +1,399 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <random>
+#include <cmath>
+#include <climits>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "SystemState.h"
+#include "Options.h"
+#include "Trace.h"
+
+using namespace std;
+
+/**
+ * @struct WorkloadSettings
+ * @brief The distributions of a generated workload, set from the command line.
+ */
+struct WorkloadSettings {
+    /** The number of jobs that arrive. */
+    int jobs = 1000;
+    
+    unsigned int seed = 1;
+    
+    /**
+     * Whether jobs arrive in bursts, a tenth of the mean gap apart, with quiet
+     * gaps between bursts; otherwise arrivals are a Poisson process.
+     */
+    bool bursty = false;
+    
+    /** The mean time between two arrivals, over the whole workload. */
+    double mean_gap = 10;
+    
+    /** The mean number of jobs in a burst. */
+    double burst_size = 20;
+    
+    /**
+     * Whether runtimes follow a Pareto distribution (shape 1.5), so a few jobs
+     * run far longer than the rest; otherwise they are exponential.
+     */
+    bool heavy_tailed = true;
+    
+    double mean_runtime = 8;
+    int max_runtime = 10000;
+    
+    // The configuration line
+    int memory = 1000;
+    int time_excess = 30;
+    int devices = 12;
+    int quantum = 4;
+    
+    /**
+     * The share of jobs that need a quarter to all of the memory; the others
+     * need at most a twentieth of it.
+     */
+    double big_jobs = 0.05;
+    
+    /** The largest number of devices a job may claim. */
+    int max_claim = 4;
+    
+    /** The mean time between two device requests or releases. */
+    double device_gap = 20;
+    
+    /** The share of device lines that are requests, when a job could do either. */
+    double request_share = 0.6;
+    
+    /** The time between two displays, or 0 for no displays but the last. */
+    int display_every = 0;
+    
+    /** The scheduling policy the file is meant for, which decides who is on the CPU. */
+    SchedulingPolicy policy = SchedulingPolicy::RoundRobin;
+};
+
+/**
+ * @brief Parses a number option, which must be at least a given minimum.
+ * @throws runtime_error if the value is not a number or is too small.
+ */
+double parse_number(const string& name, const string& value, double minimum) {
+    char* end;
+    double number = strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || !(number >= minimum)) {
+        throw runtime_error("Error: " + name + " must be a number of at least "
+                            + to_string((int) minimum) + ".");
+    }
+    return number;
+}
+
+WorkloadSettings parse_settings(int argc, char** argv) {
+    WorkloadSettings settings;
+    for (int i = 2; i < argc; i++) {
+        string name;
+        string value;
+        split_option(argv[i], name, value);
+        if (name == "--jobs") {
+            settings.jobs = parse_number(name, value, 1);
+        } else if (name == "--seed") {
+            settings.seed = parse_number(name, value, 0);
+        } else if (name == "--arrivals") {
+            if (value == "poisson") {
+                settings.bursty = false;
+            } else if (value == "bursty") {
+                settings.bursty = true;
+            } else {
+                throw runtime_error("Error: --arrivals must be poisson or bursty.");
+            }
+        } else if (name == "--mean-gap") {
+            settings.mean_gap = parse_number(name, value, 0);
+        } else if (name == "--burst-size") {
+            settings.burst_size = parse_number(name, value, 1);
+        } else if (name == "--runtimes") {
+            if (value == "pareto") {
+                settings.heavy_tailed = true;
+            } else if (value == "exponential") {
+                settings.heavy_tailed = false;
+            } else {
+                throw runtime_error("Error: --runtimes must be pareto or exponential.");
+            }
+        } else if (name == "--mean-runtime") {
+            settings.mean_runtime = parse_number(name, value, 1);
+        } else if (name == "--max-runtime") {
+            settings.max_runtime = parse_number(name, value, 1);
+        } else if (name == "--memory") {
+            settings.memory = parse_number(name, value, 20);
+        } else if (name == "--time-excess") {
+            settings.time_excess = parse_number(name, value, 1);
+        } else if (name == "--devices") {
+            settings.devices = parse_number(name, value, 0);
+        } else if (name == "--quantum") {
+            settings.quantum = parse_number(name, value, 1);
+        } else if (name == "--big-jobs") {
+            settings.big_jobs = parse_number(name, value, 0);
+        } else if (name == "--max-claim") {
+            settings.max_claim = parse_number(name, value, 0);
+        } else if (name == "--device-gap") {
+            settings.device_gap = parse_number(name, value, 1);
+        } else if (name == "--request-share") {
+            settings.request_share = parse_number(name, value, 0);
+        } else if (name == "--display-every") {
+            settings.display_every = parse_number(name, value, 0);
+        } else if (name == "--policy") {
+            // Parsed as project_cs641 does
+            char* args[] = { argv[0], argv[1], argv[i] };
+            settings.policy = parse_options(3, args).policy;
+        } else {
+            throw runtime_error("Error: Unknown option " + name);
+        }
+    }
+    if (settings.max_claim > settings.devices) {
+        throw runtime_error("Error: --max-claim must not be more than --devices.");
+    }
+    return settings;
+}
+
+/**
+ * @brief Processes the events of the model up to a given time, as project_cs641
+ * does after each command.
+ */
+void run_through(int time, SystemState& state) {
+    while (state.has_next_event() && state.get_next_event_time() <= time) {
+        state.set_time(state.get_next_event_time());
+        state.process_next_event();
+        state.update_queues();
+    }
+}
+
+/**
+ * @class WorkloadGenerator
+ * @brief Writes the lines of an input file drawn from the distributions of a
+ * WorkloadSettings.
+ *
+ * A device request or release only takes effect if its job is on the CPU at its
+ * time, which depends on all the scheduling before it. So the generator feeds
+ * every line it writes to a SystemState of its own, and addresses each device
+ * line to the job that model has on the CPU: requests stay within what the job
+ * still may claim, and releases within what it holds. Device lines are left out
+ * at times when the model has another event due, whose order against the line
+ * would decide which job is on the CPU.
+ */
+class WorkloadGenerator {
+public:
+    WorkloadGenerator(const WorkloadSettings& settings, ostream& out)
+    : m_settings(settings), m_out(out), m_random(settings.seed), m_state(nullptr),
+      m_last_time(1), m_jobs(0), m_device_lines(0), m_displays(0) {
+    }
+    
+    ~WorkloadGenerator() {
+        delete m_state;
+    }
+    
+    WorkloadGenerator(const WorkloadGenerator&) = delete;
+    WorkloadGenerator& operator= (const WorkloadGenerator&) = delete;
+    
+    /**
+     * @brief Writes the configuration, the jobs with device lines and displays
+     * in between, and a last display once every job has completed.
+     */
+    void generate() {
+        Options options;
+        // Completed jobs are of no more use to the model
+        options.stream = true;
+        options.policy = m_settings.policy;
+        m_state = new SystemState(m_settings.memory, m_settings.time_excess,
+                                  DeviceVector(m_settings.devices), 1,
+                                  m_settings.quantum, 1, options);
+        m_lines += "C 1 M=" + to_string(m_settings.memory)
+                   + " L=" + to_string(m_settings.time_excess)
+                   + " S=" + to_string(m_settings.devices)
+                   + " Q=" + to_string(m_settings.quantum) + "\n";
+        
+        double arrival_clock = 1 + next_arrival_gap();
+        double device_clock = 1 + exponential(m_settings.device_gap);
+        int display_time = (m_settings.display_every > 0) ? 1 + m_settings.display_every
+                                                           : INT_MAX;
+        while (m_jobs < m_settings.jobs) {
+            int arrival_time = (int) arrival_clock;
+            int device_time = (int) device_clock;
+            if (device_time <= arrival_time && device_time <= display_time) {
+                if (device_time > m_last_time) {
+                    write_device_line(device_time);
+                }
+                device_clock += exponential(m_settings.device_gap);
+            } else if (display_time <= arrival_time) {
+                write_display(display_time);
+                display_time += m_settings.display_every;
+            } else {
+                write_arrival(arrival_time);
+                arrival_clock += next_arrival_gap();
+            }
+            flush(false);
+        }
+        
+        // Run the model until every job has completed, so the last display
+        // shows them all
+        run_through(INT_MAX, *m_state);
+        write_display(max(m_last_time, m_state->get_time()));
+        flush(true);
+    }
+    
+    unsigned long get_jobs() const { return m_jobs; }
+    unsigned long get_device_lines() const { return m_device_lines; }
+    unsigned long get_displays() const { return m_displays; }
+    int get_end_time() const { return m_last_time; }
+
+private:
+    const WorkloadSettings& m_settings;
+    ostream& m_out;
+    mt19937 m_random;
+    SystemState* m_state;
+    string m_lines;
+    int m_last_time;
+    int m_jobs;
+    unsigned long m_device_lines;
+    unsigned long m_displays;
+    
+    double uniform() {
+        return uniform_real_distribution<double>(0, 1)(m_random);
+    }
+    
+    /** @brief Draws a whole number from low to high, inclusive. */
+    int uniform(int low, int high) {
+        return uniform_int_distribution<int>(low, high)(m_random);
+    }
+    
+    double exponential(double mean) {
+        return (mean > 0) ? exponential_distribution<double>(1 / mean)(m_random) : 0;
+    }
+    
+    double next_arrival_gap() {
+        if (!m_settings.bursty) {
+            return exponential(m_settings.mean_gap);
+        }
+        // A burst ends after each job with probability 1 / burst_size; its quiet
+        // gap makes up for the short gaps within the burst
+        double gap = exponential(m_settings.mean_gap / 10);
+        if (uniform() < 1 / m_settings.burst_size) {
+            gap += exponential(m_settings.burst_size * m_settings.mean_gap * 0.9);
+        }
+        return gap;
+    }
+    
+    int next_runtime() {
+        double runtime;
+        if (m_settings.heavy_tailed) {
+            const double SHAPE = 1.5;
+            double scale = m_settings.mean_runtime * (SHAPE - 1) / SHAPE;
+            runtime = scale / pow(1 - uniform(), 1 / SHAPE);
+        } else {
+            runtime = exponential(m_settings.mean_runtime);
+        }
+        runtime = ceil(runtime);
+        return (runtime < m_settings.max_runtime) ? max((int) runtime, 1)
+                                                  : m_settings.max_runtime;
+    }
+    
+    void write_arrival(int time) {
+        m_jobs++;
+        int memory = (uniform() < m_settings.big_jobs)
+                     ? uniform(m_settings.memory / 4, m_settings.memory)
+                     : uniform(1, m_settings.memory / 20);
+        int claim = uniform(0, m_settings.max_claim);
+        int runtime = next_runtime();
+        int priority = uniform(1, 2);
+        m_lines += "A " + to_string(time) + " J=" + to_string(m_jobs)
+                   + " M=" + to_string(memory) + " S=" + to_string(claim)
+                   + " R=" + to_string(runtime) + " P=" + to_string(priority) + "\n";
+        m_last_time = time;
+        
+        m_state->schedule_arrival(time, Job(time, m_jobs, memory, DeviceVector(claim),
+                                            runtime, priority));
+        run_through(time, *m_state);
+    }
+    
+    /**
+     * @brief Writes a device request or release of the job on the CPU of the
+     * model at a given time, if there is one and nothing else happens then.
+     */
+    void write_device_line(int time) {
+        run_through(time - 1, *m_state);
+        int job_id = m_state->cpu_get_job();
+        if (job_id == NoJob
+            || (m_state->has_next_event() && m_state->get_next_event_time() == time)) {
+            return;
+        }
+        const JobTable& jobs = m_state->get_jobs();
+        int held = jobs.get_allocated_devices(job_id)[0];
+        int need = jobs.get_max_devices(job_id)[0] - held;
+        if (need <= 0 && held <= 0) {
+            return;
+        }
+        bool request = (need > 0) && (held <= 0 || uniform() < m_settings.request_share);
+        int devices = uniform(1, request ? need : held);
+        int number = jobs.get_number(job_id);
+        m_lines += string(request ? "Q " : "L ") + to_string(time)
+                   + " J=" + to_string(number) + " D=" + to_string(devices) + "\n";
+        m_last_time = time;
+        m_device_lines++;
+        
+        if (request) {
+            m_state->schedule_device_request(time, number, DeviceVector(devices));
+        } else {
+            m_state->schedule_device_release(time, number, DeviceVector(devices));
+        }
+        run_through(time, *m_state);
+    }
+    
+    void write_display(int time) {
+        m_lines += "D " + to_string(time) + "\n";
+        m_last_time = time;
+        m_displays++;
+    }
+    
+    /** @brief Writes the buffered lines once there are enough of them, or if forced. */
+    void flush(bool force) {
+        if (force || m_lines.size() >= (1 << 20)) {
+            m_out << m_lines;
+            m_lines.clear();
+        }
+    }
+};
+
+/**
+ * Writes a synthetic input file for project_cs641, to measure how the simulator
+ * scales with the number of jobs. Usage: workload_generator <output> [options]
+ *
+ * The options (see instructions.txt) set the arrival process, the runtimes,
+ * the memory and device demand of the jobs, how often the job on the CPU
+ * requests or releases devices, and how often to display.
+ *
+ * @param argc The number of command line arguments.
+ * @param argv An array of command line arguments.
+ * @return Returns 0 upon success.
+ * @throws runtime_error If the output file is missing or cannot be written, or
+ * an option is invalid.
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        throw runtime_error("Error: Please specify an output file.");
+    }
+    WorkloadSettings settings = parse_settings(argc, argv);
+    ofstream out_file(argv[1]);
+    if (out_file.fail()) {
+        throw runtime_error("Error: Could not open specified output file.");
+    }
+    Trace::set_level(TraceLevel::None);
+    
+    WorkloadGenerator generator(settings, out_file);
+    generator.generate();
+    out_file.close();
+    if (out_file.fail()) {
+        throw runtime_error("Error: Could not write specified output file.");
+    }
+    
+    cout << "Generated " << generator.get_jobs() << " jobs, "
+         << generator.get_device_lines() << " device requests and releases and "
+         << generator.get_displays() << " displays, ending at time "
+         << generator.get_end_time() << endl;
+    return 0;
+}
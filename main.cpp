@@ -1,201 +1,284 @@
 #include <iostream>
 #include <string>
-#include <fstream>
-#include <sstream>
-#include <vector>
-#include <deque>
 #include <stdexcept>
-#include <unordered_map>
+#include <chrono>
+#include <memory>
 
 #include "SystemState.h"
 #include "Event.h"
-#include "JobArrivalEvent.h"
-#include "DeviceRequestEvent.h"
-#include "DeviceReleaseEvent.h"
-#include "DisplayEvent.h"
 #include "Job.h"
-
-#define CONFIGURATION "C"
-#define MAX_MEMORY "M"
-#define TIME_EXCESS "L"
-#define MAX_DEVICES "S"
-#define QUANTUM_LENGTH "Q"
-#define JOB_ARRIVAL "A"
-#define JOB_NUMBER "J"
-#define RUNTIME "R"
-#define PRIORITY "P"
-#define DEVICE_REQUEST "Q"
-#define NUM_DEVICES "D"
-#define DEVICE_RELEASE "L"
-#define DISPLAY "D"
+#include "Options.h"
+#include "MappedFile.h"
+#include "CommandParser.h"
+#include "BinaryTrace.h"
+#include "ParallelCommandParser.h"
+#include "SnapshotWriter.h"
+#include "Trace.h"
 
 using namespace std;
 
 /**
- * @brief Parses the command tokens and returns a map of parameter-value pairs.
+ * @brief Parses a whole input file and prints how long it took.
  * 
- * @param tokens The command tokens to parse.
- * @return unordered_map<string, int> A map of parameter-value pairs.
- * @throws runtime_error if the input line is malformed.
- */
-unordered_map<string, int> parse_command_tokens(const vector<string>& tokens) {
-    unordered_map<string, int> pairs;
-    for (unsigned int i = 2; i < tokens.size(); i++) {
-        if (tokens[i].size() < 3) {
-            throw runtime_error("Error: Malformed input line");
-        }
-        string parameter = tokens[i].substr(0, 1);
-        string value = tokens[i].substr(2);
-        pairs.insert({{parameter, atoi(value.c_str())}});
-    }
-    return pairs;
-}
-
-/**
- * @brief Splits a string into tokens based on a delimiter.
+ * This measures the parser on its own, without the cost of simulating the 
+ * commands.
  * 
- * @param str The string to split.
- * @param delimiter The delimiter character.
- * @return vector<string> A vector of tokens.
+ * @param commands The parser of the input file (CommandParser, 
+ * ParallelCommandParser or BinaryTraceReader).
+ * @param input The contents of the input file.
+ * @throws runtime_error if the input is malformed.
  */
-vector<string> split(const string& str, char delimiter) {
-   vector<string> tokens;
-   string token;
-   istringstream tokenStream(str);
-   while (getline(tokenStream, token, delimiter)) {
-      tokens.push_back(token);
-   }
-   return tokens;
+template <typename Source>
+void report_parse_speed(Source& commands, string_view input) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    Command command;
+    unsigned long count = 0;
+    while (commands.next(command)) {
+        count++;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    cout << "commands: " << count << endl;
+    cout << "bytes: " << input.size() << endl;
+    cout << "parse_seconds: " << seconds << endl;
+    cout << "parse_mb_per_second: " 
+         << (seconds > 0 ? input.size() / seconds / 1e6 : 0) << endl;
 }
 
 /**
  * @brief Processes events up to a given time in the system state.
  * 
+ * In batched mode, all events with the same time are processed together and the 
+ * queues are updated once at the end. Between two events, the queues are only 
+ * updated if the pending pass would change something (see 
+ * SystemState::needs_update()), so the result is the same as updating after 
+ * every event.
+ * 
  * @param time The time up to which events should be processed.
  * @param state The system state.
+ * @param batch Whether to batch events with the same time.
  */
-void process_events_through_time(int time, SystemState& state) {
-    while (state.has_next_event() && state.get_next_event()->get_time() <= time) {
+void process_events_through_time(int time, SystemState& state, bool batch) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (state.has_next_event() && state.get_next_event_time() <= time) {
         // Step cpu to current time (which will reduce remaining time for 
         // current process if necessary)
-        int event_time = state.get_next_event()->get_time();
+        int event_time = state.get_next_event_time();
         state.set_time(event_time);
         
         // Process event
-        Event* e = state.pop_next_event();
-        e->process(state);
-        delete e;
+        state.process_next_event();
         
-        // Update queues and move jobs on/off CPU if necessary
-        state.update_queues();
+        if (batch) {
+            // Process the remaining events at this time
+            while (state.has_next_event() && state.get_next_event_time() == event_time) {
+                state.update_queues_if_needed();
+                state.set_time(event_time);
+                state.process_next_event();
+            }
+            state.update_queues_if_needed();
+        } else {
+            // Update queues and move jobs on/off CPU if necessary
+            state.update_queues();
+        }
     }
+    state.record_event_loop_time(chrono::steady_clock::now() - start);
 }
 
 /**
- * The main function is the entry point of the program.
- * It reads an input file, parses the commands, and schedules events accordingly.
- * The function takes command line arguments as input, where the first argument is the input file path.
- * If no input file is specified, it throws a runtime error.
- * If the input file cannot be found, it throws a runtime error.
+ * @brief Simulates the commands of an input file.
  * 
- * @param argc The number of command line arguments.
- * @param argv An array of command line arguments.
- * @return Returns 0 upon successful execution.
- * @throws runtime_error If the input file is not specified or cannot be found.
+ * @param commands The parser of the input file (CommandParser, 
+ * ParallelCommandParser or BinaryTraceReader).
+ * @param filename The input file path without its extension, used to name 
+ * display files.
+ * @param options The run-time settings.
+ * @param writer The writer of asynchronous displays, or null to display on this 
+ * thread.
+ * @return Returns 0 upon successful execution, or 1 on an unknown input command.
+ * @throws runtime_error If the input is malformed.
  */
-int main(int argc, char** argv) {
-    if (argc < 2) {
-        throw runtime_error("Error: Please specify an input file.");
-    }
-    ifstream in_file(argv[1]);
-    if (in_file.fail()) {
-        throw runtime_error("Error: Could not find specified input file.");
-    }
-    
-    string filename(argv[1]);
-    filename.erase(filename.find_last_of("."), string::npos);
-    
-    SystemState* state;
+template <typename Source>
+int simulate_commands(Source& commands, const string& filename, const Options& options, 
+                      SnapshotWriter* writer) {
+    SystemState* state = nullptr;
     
     bool explicit_final_print = false;
+    int last_command_time = 0;
     
-    for (string line; getline(in_file, line);) {
-        vector<string> tokens = split(line, ' ');
-        if (tokens.size() < 2) {
-            throw runtime_error("Error: Malformed input line");
+    for (Command command; commands.next(command);) {
+        int command_time = command.time;
+        
+        if (options.batch && state != nullptr) {
+            // Leave events at the current time pending until a later command 
+            // arrives, so that they are processed as one batch (unless the input 
+            // goes back in time, in which case everything pending is processed). 
+            // With LIFO ties, pending commands at the same time would come out 
+            // of the queue in reverse file order, so they are processed before 
+            // the next command at that time is queued.
+            bool keeps_order = options.event_order == TieOrder::Fifo;
+            int through_time = (command_time < last_command_time 
+                                || (command_time == last_command_time && !keeps_order)) 
+                               ? last_command_time : command_time - 1;
+            process_events_through_time(through_time, *state, options.batch);
         }
-        int command_time = atoi(tokens[1].c_str());
+        last_command_time = command_time;
         
-        if (tokens[0] == CONFIGURATION) {
-            cout << command_time << ": System configuration" << endl;
-            unordered_map<string, int> pairs = parse_command_tokens(tokens);
-            try {
+        switch (command.type) {
+            case Command::Type::Configuration:
+                TRACE(TraceLevel::Events, command_time << ": System configuration");
                 state = new SystemState(
-                    pairs.at(MAX_MEMORY),
-                    pairs.at(TIME_EXCESS), 
-                    pairs.at(MAX_DEVICES), 
-                    pairs.at(QUANTUM_LENGTH),
-                    command_time);
-            } catch (const out_of_range& e) {
-                throw runtime_error("Error: Malformed input line");
-            }
-        } else if (tokens[0] == JOB_ARRIVAL) {
-            unordered_map<string, int> pairs = parse_command_tokens(tokens);
-            try {
+                    command.memory,
+                    command.time_excess, 
+                    command.devices, 
+                    command.device_classes, 
+                    command.quantum_length,
+                    command_time,
+                    options);
+                state->set_snapshot_writer(writer);
+                break;
+            case Command::Type::JobArrival: {
                 Job job(
                     command_time,
-                    pairs.at(JOB_NUMBER),
-                    pairs.at(MAX_MEMORY),
-                    pairs.at(MAX_DEVICES),
-                    pairs.at(RUNTIME),
-                    pairs.at(PRIORITY));
-                Event* e = new JobArrivalEvent(command_time, job);
-                state->schedule_event(e);
-            } catch (const out_of_range& e) {
-                throw runtime_error("Error: Malformed input line");
-            }
-        } else if (tokens[0] == "Q") {
-            unordered_map<string, int> pairs = parse_command_tokens(tokens);
-            try {
-                Event* e = new DeviceRequestEvent(command_time, 
-                                                  pairs.at(JOB_NUMBER),
-                                                  pairs.at(NUM_DEVICES));
-                state->schedule_event(e);
-            } catch (const out_of_range& e) {
-                throw runtime_error("Error: Malformed input line");
-            }
-        } else if (tokens[0] == "L") {
-            unordered_map<string, int> pairs = parse_command_tokens(tokens);
-            try {
-                Event* e = new DeviceReleaseEvent(command_time, 
-                                                  pairs.at(JOB_NUMBER),
-                                                  pairs.at(NUM_DEVICES));
-                state->schedule_event(e);
-            } catch (const out_of_range& e) {
-                throw runtime_error("Error: Malformed input line");
+                    command.job_number,
+                    command.memory,
+                    command.devices,
+                    command.runtime,
+                    command.priority);
+                state->schedule_arrival(command_time, job);
+                break;
             }
-        } else if (tokens[0] == "D") {
-            if (command_time >= END_TIME) {
-                explicit_final_print = true;
-            }
-            Event* e = new DisplayEvent(command_time, filename);
-            state->schedule_event(e);
-        } else {
-            cerr << command_time << ": Unknown input command" << endl;
-            return 1;
+            case Command::Type::DeviceRequest:
+                state->schedule_device_request(command_time, 
+                                               command.job_number,
+                                               command.devices);
+                break;
+            case Command::Type::DeviceRelease:
+                state->schedule_device_release(command_time, 
+                                               command.job_number,
+                                               command.devices);
+                break;
+            case Command::Type::Display:
+                if (command_time >= END_TIME) {
+                    explicit_final_print = true;
+                }
+                state->schedule_display(command_time, filename);
+                break;
+            case Command::Type::Unknown:
+                cerr << command_time << ": Unknown input command" << endl;
+                return 1;
         }
         
-        process_events_through_time(command_time, *state);
+        if (!options.batch) {
+            process_events_through_time(command_time, *state, options.batch);
+        }
     }
+    process_events_through_time(last_command_time, *state, options.batch);
     
     if (!explicit_final_print) {
-        Event* e = new DisplayEvent(END_TIME, filename);
-        state->schedule_event(e);
+        state->schedule_display(END_TIME, filename);
         
-        process_events_through_time(END_TIME, *state);
+        process_events_through_time(END_TIME, *state, options.batch);
+    }
+    
+    if (writer != nullptr) {
+        writer->finish();
+    }
+    
+    if (options.stats) {
+        state->print_stats(cerr);
     }
     
     delete state;
     
     return 0;
 }
+
+/**
+ * @brief Simulates the commands of an input file, writing displays on a 
+ * background thread if options.async_display is set (see SnapshotWriter), and 
+ * printing the last scheduler decisions at the end if they are recorded.
+ * 
+ * The parameters are those of simulate_commands().
+ */
+template <typename Source>
+int simulate(Source& commands, const string& filename, const Options& options) {
+    unique_ptr<SnapshotWriter> writer;
+    if (options.async_display) {
+        writer = make_unique<SnapshotWriter>(options.display_queue, options.display_overflow, 
+                                             options.delta_display);
+    }
+    try {
+        int result = simulate_commands(commands, filename, options, writer.get());
+        if (Trace::recording_decisions()) {
+            Trace::dump_decisions(cerr);
+        }
+        return result;
+    } catch (...) {
+        // Print the output so far, which is buffered, before the error ends the 
+        // program
+        if (writer != nullptr) {
+            writer->finish();
+        }
+        cout.flush();
+        if (Trace::recording_decisions()) {
+            Trace::dump_decisions(cerr);
+        }
+        throw;
+    }
+}
+
+/**
+ * The main function is the entry point of the program.
+ * It reads an input file, parses the commands, and schedules events accordingly.
+ * The function takes command line arguments as input, where the first argument is the input file path
+ * and any further arguments are options (see parse_options()).
+ * The input file is either a text file or a binary trace (see BinaryTrace.h), 
+ * which is recognized by its header.
+ * If no input file is specified, it throws a runtime error.
+ * If the input file cannot be found, it throws a runtime error.
+ * 
+ * @param argc The number of command line arguments.
+ * @param argv An array of command line arguments.
+ * @return Returns 0 upon successful execution.
+ * @throws runtime_error If the input file is not specified or cannot be found.
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        throw runtime_error("Error: Please specify an input file.");
+    }
+    // Trace output is not flushed line by line, so let std::cout buffer it 
+    // instead of passing every write on to stdio
+    ios::sync_with_stdio(false);
+    Options options = parse_options(argc, argv);
+    Trace::set_level(options.trace_level);
+    Trace::record_decisions(options.trace_decisions);
+    MappedFile in_file(argv[1]);
+    string_view input = in_file.contents();
+    
+    string filename(argv[1]);
+    filename.erase(filename.find_last_of("."), string::npos);
+    
+    if (BinaryTraceReader::is_binary_trace(input)) {
+        BinaryTraceReader commands(input);
+        if (options.parse_only) {
+            report_parse_speed(commands, input);
+            return 0;
+        }
+        return simulate(commands, filename, options);
+    } else if (options.parse_threads > 1) {
+        ParallelCommandParser commands(input, options.parse_threads);
+        if (options.parse_only) {
+            report_parse_speed(commands, input);
+            return 0;
+        }
+        return simulate(commands, filename, options);
+    } else {
+        CommandParser commands(input);
+        if (options.parse_only) {
+            report_parse_speed(commands, input);
+            return 0;
+        }
+        return simulate(commands, filename, options);
+    }
+}